@@ -0,0 +1,31 @@
+#pragma once
+
+/* ******************************************************************************* */
+/* Auton executor that keeps a routine inside its time budget. Each step knows how */
+/* long it normally takes (learned from earlier runs and saved on the SD card) and */
+/* what it is worth. Before an optional step starts, the executor picks the set of */
+/* remaining steps worth the most points that still fits the time left, and skips  */
+/* the step if it is not in that set.                                              */
+/* ******************************************************************************* */
+
+#define AUTON_EXECUTOR_MAX_STEPS 16
+
+/// @brief One step of a time budgeted auton
+struct AutonStep {
+  const char* name;
+  void (*action)();
+  float expectedSeconds;  //First guess; replaced by the learned time once the step has run
+  int points;  //0 = required (always runs); otherwise what the step is worth if it runs
+  bool needsPreviousStep;  //Only makes sense if the step before it ran (it starts from where that one ends)
+};
+
+/// @brief Run the first runCount steps in order, skipping optional ones that would not fit in the time budget
+/// @param timingFile SD card file with the learned step times for this routine (every step, run or not)
+/// @param steps steps in the order they run
+/// @param stepCount number of steps in the routine (at most AUTON_EXECUTOR_MAX_STEPS)
+/// @param runCount how many of them to run this time (elims leave steps off the end), so every mode shares one timing file
+/// @param budgetSeconds time from autonStartTime the routine has to finish in
+void runAutonSteps(const char* timingFile, const AutonStep steps[], int stepCount, int runCount, double budgetSeconds);
+
+/// @brief Sleep until budgetSeconds after autonStartTime (mechanisms keep doing whatever they were doing)
+void waitForAutonEnd(double budgetSeconds);
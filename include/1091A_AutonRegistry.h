@@ -0,0 +1,65 @@
+#pragma once
+#include "autons.h"
+#include "1091A_TuningConsole.h"
+
+/* ******************************************************************************* */
+/* Every selectable auton, in selector order. Selection, the brain screen label    */
+/* and the color sorting setup are all read from this one table, so adding a       */
+/* routine is one new line here and nothing else can get out of step.             */
+/* ******************************************************************************* */
+
+enum AutonColor { AUTON_COLOR_PURPLE, AUTON_COLOR_RED, AUTON_COLOR_BLUE, AUTON_COLOR_GREEN, AUTON_COLOR_ORANGE };
+enum Alliance { ALLIANCE_NONE, ALLIANCE_RED, ALLIANCE_BLUE, ALLIANCE_FROM_SCRIPT };  //ALLIANCE_FROM_SCRIPT uses the SD script's "reject" line
+
+/// @brief One selectable auton
+struct AutonDescriptor {
+  const char* name;  //Brain screen label (at most autonNameMaxLength characters)
+  AutonColor color;  //Brain screen fill color
+  Alliance alliance;  //The other alliance's rings are sorted out (blue ones for ALLIANCE_NONE)
+  void (*entry)();  //Runs in the autonomous period
+  float expectedSeconds;  //How long the routine normally takes
+  void (*driverControl)();  //Runs at the start of driver control instead of the normal drive loop (nullptr for none)
+};
+
+const int autonNameMaxLength = 15;
+
+constexpr AutonDescriptor autonRegistry[] = {
+  {"SKILLS",         AUTON_COLOR_PURPLE, ALLIANCE_RED,         skills_auto,               60.0, nullptr},
+  {"RED WIN POINT",  AUTON_COLOR_RED,    ALLIANCE_RED,         red_wp_qual_auto,          15.0, nullptr},
+  {"RED RIGHT QUAL", AUTON_COLOR_RED,    ALLIANCE_RED,         red_right_qual_nopid_auto, 15.0, nullptr},
+  {"ELIMS RED",      AUTON_COLOR_RED,    ALLIANCE_RED,         red_wp_elims_auto,         15.0, nullptr},
+  {"BLUE WIN POINT", AUTON_COLOR_BLUE,   ALLIANCE_BLUE,        blue_wp_qual_auto,         15.0, nullptr},
+  {"BLUE LEFT QUAL", AUTON_COLOR_BLUE,   ALLIANCE_BLUE,        blue_left_qual_nopid_auto, 15.0, nullptr},
+  {"ELIMS BLUE",     AUTON_COLOR_BLUE,   ALLIANCE_BLUE,        blue_wp_elims_auto,        15.0, nullptr},
+  {"DRIVE TEST",     AUTON_COLOR_GREEN,  ALLIANCE_NONE,        drive_test,                5.0,  nullptr},
+  {"TURN TEST",      AUTON_COLOR_GREEN,  ALLIANCE_NONE,        turn_test,                 5.0,  nullptr},
+  {"BENCHMARK",      AUTON_COLOR_GREEN,  ALLIANCE_NONE,        benchmark_test,            2.0,  nullptr},
+  {"PATH TEST",      AUTON_COLOR_GREEN,  ALLIANCE_NONE,        path_test,                 5.0,  nullptr},
+  {"PID TUNER",      AUTON_COLOR_GREEN,  ALLIANCE_NONE,        no_auton,                  0.0,  tuning_console},
+  {"SD ROUTINE",     AUTON_COLOR_ORANGE, ALLIANCE_FROM_SCRIPT, sd_script_auto,            15.0, nullptr},
+};
+
+constexpr int autonCount = sizeof(autonRegistry)/sizeof(autonRegistry[0]);
+
+constexpr int constStringLength(const char* s) {
+  return *s == '\0' ? 0 : 1 + constStringLength(s + 1);
+}
+
+/// @brief A red or blue label has to be on that alliance, so the screen can't show one color while the other is sorted out
+constexpr bool autonColorMatchesAlliance(const AutonDescriptor& auton) {
+  return (auton.color != AUTON_COLOR_RED || auton.alliance == ALLIANCE_RED) &&
+    (auton.color != AUTON_COLOR_BLUE || auton.alliance == ALLIANCE_BLUE);
+}
+
+/// @brief Checked at compile time: every entry has a label that fits the screen, an entry function and a label color
+/// that agrees with its alliance
+constexpr bool autonEntriesValid(int index) {
+  return index >= autonCount ||
+    (constStringLength(autonRegistry[index].name) <= autonNameMaxLength &&
+     autonRegistry[index].entry != nullptr &&
+     autonColorMatchesAlliance(autonRegistry[index]) &&
+     autonEntriesValid(index + 1));
+}
+
+static_assert(autonCount > 0, "autonRegistry is empty");
+static_assert(autonEntriesValid(0), "autonRegistry entry has a name longer than autonNameMaxLength, no entry function, or a color that is not its alliance");
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+
+/* ******************************************************************************* */
+/* Auton routines described in a text file on the SD card, so values can be changed */
+/* between matches without a rebuild. See sd/auton.txt for the format.             */
+/* ******************************************************************************* */
+
+#define AUTON_SCRIPT_MAX_COMMANDS 160
+#define AUTON_SCRIPT_MAX_ARGS 3
+#define AUTON_SCRIPT_MAX_FILE_BYTES 8192
+
+enum AutonOp : uint8_t {
+  OP_SETUP, OP_REJECT,
+  OP_DRIVE, OP_DRIVE_SMALL, OP_DRIVE_MEDIUM, OP_DRIVE_LARGE, OP_DRIVE_MAX_VOLTAGE, OP_DRIVE_TIMEOUT,
+  OP_TURN_TINY, OP_TURN_SMALL, OP_TURN_MEDIUM, OP_TURN_LARGE, OP_TURN_XLARGE, OP_ADJUST_HEADING,
+  OP_SWING, OP_SWING_BACK,
+  OP_VOLTAGE, OP_STOP, OP_SLEEP, OP_BACK_UNTIL_MM, OP_WAIT_FOR_END,
+  OP_CLAMP, OP_RELEASE, OP_DOINKER_DOWN, OP_DOINKER_UP,
+  OP_INTAKE_FORWARD, OP_INTAKE_REVERSE, OP_INTAKE_STOP, OP_SHOOT_ALLIANCE,
+  OP_ARM_RECEIVE, OP_ARM_LADDER, OP_ARM_DOWN,
+  OP_GRAB_MOGO
+};
+
+/// @brief One parsed line of an auton script
+struct AutonCommand {
+  AutonOp op;
+  uint8_t argCount;
+  uint16_t line;
+  float args[AUTON_SCRIPT_MAX_ARGS];
+};
+
+/// @brief Whole parsed script.  Lives in a fixed size static array; nothing is allocated at runtime
+struct AutonScript {
+  AutonCommand commands[AUTON_SCRIPT_MAX_COMMANDS];
+  int commandCount = 0;
+  bool loaded = false;
+  bool rejectRedRings = false;
+  int errorLine = 0;  //First line that failed to parse (0 if none)
+};
+
+extern AutonScript autonScript;
+
+bool loadAutonScript(const char* fileName);
+bool parseAutonScript(char* text, int length, AutonScript& script);
+void runAutonScript();
@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+
+/* ******************************************************************************* */
+/* Timing for the math that runs every control tick (PID, odometry, voltage        */
+/* scaling, settling, the drive_to_pose carrot and the MPC). The same code runs on */
+/* the brain (BENCHMARK in the auton selector) and on a PC (make bench-host), so   */
+/* the CPU cost per tick can be budgeted before adding more to the loops.          */
+/* ******************************************************************************* */
+
+#define KERNEL_BENCHMARK_COUNT 8
+
+//Clock of the V5 brain's user processor, for turning time into cycles
+const float v5ClockMHz = 667.0;
+
+/// @brief Timing of one kernel
+struct KernelBenchmark {
+  const char* name;
+  float nsPerCall;
+  float cyclesPerCall;
+};
+
+/// @brief Time each kernel over the same synthetic drive (an S-curve at 100Hz)
+/// @param microseconds clock to time with (vex::timer::systemHighResolution on the brain)
+/// @param clockMHz CPU clock, used to turn time into cycles
+/// @param results filled with KERNEL_BENCHMARK_COUNT results
+void runKernelBenchmarks(uint64_t (*microseconds)(), float clockMHz, KernelBenchmark results[]);
@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include "1091A_MotionPresets.h"
+
+/* ******************************************************************************* */
+/* Tuning constants and routine offsets kept on the SD card, so they can change    */
+/* without a rebuild. config.bin is a small header and then the RobotConfig struct */
+/* byte for byte, so loading it is one checksum and one memcpy. A missing file, or */
+/* one with the wrong version, size or checksum, leaves the compiled-in values in  */
+/* robotConfigDefaults below.                                                      */
+/*                                                                                 */
+/* The PID tuner saves the file, and tools/configgen.cpp (make configgen) turns a  */
+/* text file of "section value value ..." lines into one on a PC:                  */
+/*   configgen defaults > robot.txt         (edit robot.txt)                       */
+/*   configgen build robot.txt config.bin   (copy config.bin to the SD card)       */
+/*   configgen dump config.bin              (see what is on a card)                */
+/*                                                                                 */
+/* Everything in RobotConfig is a float, so the tool and the brain agree on the    */
+/* layout. Bump ROBOT_CONFIG_VERSION whenever a field is added, removed or moved.  */
+/* ******************************************************************************* */
+
+#define ROBOT_CONFIG_FILE_NAME "config.bin"
+#define ROBOT_CONFIG_MAGIC 0x31474643  //"CFG1"
+#define ROBOT_CONFIG_VERSION 2
+
+/// @brief Everything that can be changed from the SD card
+struct RobotConfig {
+  //Drive defaults set by default_constants()
+  turn_params turn;
+  drive_params drive;  //Drive and heading constants, drive exit conditions, min voltage and boomerang
+  turn_params swing;
+  float headingRatePerVolt;  //Inner yaw rate loop of the straight drives
+  float headingRateKp;
+  float swingMaxRate;
+  float swingMaxAccel;
+
+  //Presets used by the turn_to_heading_* and drive_distance_* functions
+  turn_params turnPresets[TURN_PRESET_COUNT];
+  drive_params drivePresets[DRIVE_PRESET_COUNT];
+
+  //Distance sensor mounting and wall relocalization
+  float frontSensorForwardOffset;
+  float backSensorForwardOffset;
+  float relocalizeGain;
+
+  //Mogo grab on the back distance sensor
+  float mogoApproachVoltage;
+  float mogoBrakingDecel;
+  float mogoClampLeadMSec;
+  float mogoApproachTimeout;
+  float mogoMaxTravel;  //Inches of backing up before giving up on a mogo
+
+  //Win point start position
+  float allianceStakeBackedUpX;
+  float wpStartY;
+};
+
+constexpr RobotConfig robotConfigDefaults = {
+  /* turn: volts, settle err, settle ms, timeout, {kp, ki, kd, starti} */ {10, 1.5, 30, 2000, {0.8, 0, 0, 5}},
+  /* drive: volts, min volts, heading volts, settle err, settle ms, timeout */ {12, 0, 6, 0.1, 0, 3000,
+    /* drive {kp, ki, kd, starti}, heading {kp, ki, kd, starti}, lead, setback */ {0.95, 0.0, 5.0, 2}, {0.4, 0, 1, 0}, 0, 0},
+  /* swing: volts, settle err, settle ms, timeout, {kp, ki, kd, starti} */ {6, 1.5, 30, 2000, {0.3, 0.001, 2, 15}},
+  /* heading rate: deg/s per volt, kp */ 50, 0.015,
+  /* swing profile: deg/s, deg/s^2 */ 360, 1200,
+  {turnTinyPreset, turnSmallPreset, turnMediumPreset, turnLargePreset, turnXLargePreset, adjustHeadingPreset},
+  {driveSmallPreset, driveMediumPreset, driveLargePreset},
+  /* front, back sensor forward offset in inches, relocalize gain */ 7.0, -7.0, 0.25,
+  /* mogo approach volts, braking mm/s^2, clamp lead ms, timeout ms, max travel in */ 12.0, 2500.0, 60.0, 2000.0, 36.0,
+  /* alliance stake backed up X, WP start Y */ 61.5, 11.3,
+};
+
+static_assert(sizeof(turn_params) == 8*sizeof(float) && sizeof(drive_params) == 16*sizeof(float),
+  "motion parameter structs must be plain floats for the config file");
+static_assert(sizeof(RobotConfig) % sizeof(float) == 0, "RobotConfig must be plain floats");
+static_assert(valid_turn_params(robotConfigDefaults.turn) && valid_drive_params(robotConfigDefaults.drive) &&
+  valid_turn_params(robotConfigDefaults.swing), "robotConfigDefaults drive constants are out of range");
+
+/// @brief Comes before the RobotConfig bytes in the file
+struct RobotConfigHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t payloadBytes;
+  uint32_t checksum;  //CRC-32 of the RobotConfig bytes
+};
+
+const int robotConfigFileBytes = sizeof(RobotConfigHeader) + sizeof(RobotConfig);
+
+enum RobotConfigStatus { CONFIG_DEFAULTS, CONFIG_LOADED, CONFIG_BAD_HEADER, CONFIG_BAD_CHECKSUM, CONFIG_BAD_VALUES };
+
+/// @brief One line of the text form: a name and the run of floats it covers
+struct RobotConfigSection {
+  const char* name;
+  int offset;  //In floats from the start of RobotConfig
+  int count;
+};
+
+extern const RobotConfigSection robotConfigSections[];
+extern const int robotConfigSectionCount;
+
+//File format (no vex calls, so tools/configgen.cpp builds it for a PC)
+uint32_t robotConfigChecksum(const uint8_t* data, int length);
+bool robotConfigValid(const RobotConfig& config);
+int encodeRobotConfig(const RobotConfig& config, uint8_t* out, int maxBytes);
+RobotConfigStatus decodeRobotConfig(const uint8_t* data, int length, RobotConfig& config);
+
+//On the brain
+extern RobotConfig robotConfig;
+extern RobotConfigStatus robotConfigStatus;
+extern uint32_t robotConfigDecodeMicros;
+
+RobotConfigStatus loadRobotConfig(const char* fileName);
+bool saveRobotConfig(const char* fileName);
+const char* robotConfigStatusText();
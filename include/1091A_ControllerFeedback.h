@@ -0,0 +1,42 @@
+#pragma once
+
+/* ******************************************************************************* */
+/* Controller screen and rumble, sent from their own task. The radio link to the   */
+/* controller takes about one message every 50 msec, so code that wants to show    */
+/* something only changes what a line should say (or queues a rumble), which never */
+/* waits. The task sends one message per slot: a queued rumble first, otherwise    */
+/* the next line whose text changed. A line changed several times between slots is */
+/* sent once with its latest text, and a rumble already waiting is not queued      */
+/* twice.                                                                          */
+/* ******************************************************************************* */
+
+#define CONTROLLER_LINE_LENGTH 19  //Characters across the controller screen
+const int controllerLineCount = 3;
+const int controllerRumbleQueueLength = 4;
+const int controllerMessageMSec = 50;
+
+//Rumble patterns ('.' short, '-' long, ' ' pause)
+#define RUMBLE_CONFIRM "."
+#define RUMBLE_WARNING "---"
+
+class ControllerFeedback {
+public:
+  void setLine(int row, const char* format, ...);
+  void clear();
+  void rumble(const char* pattern);
+  void resend();
+  bool sendNext();
+
+private:
+  char shown[controllerLineCount][CONTROLLER_LINE_LENGTH + 1] = {"", "", ""};
+  char wanted[controllerLineCount][CONTROLLER_LINE_LENGTH + 1] = {"", "", ""};
+  bool lineDirty[controllerLineCount] = {false, false, false};
+  int nextLine = 0;
+
+  const char* rumbleQueue[controllerRumbleQueueLength] = {};
+  int rumbleCount = 0;
+};
+
+extern ControllerFeedback controllerFeedback;
+
+int controllerFeedbackTask();
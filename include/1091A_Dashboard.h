@@ -0,0 +1,73 @@
+#pragma once
+
+/* ******************************************************************************* */
+/* Brain screen dashboard. Every line of text and the robot marker on the field    */
+/* map remembers what it last drew, and only what changed is drawn again, so the   */
+/* screen is never cleared and does not flicker. draw() stops once a frame has     */
+/* used its time budget; anything left over is drawn next frame, so the screen     */
+/* never takes more than a small, fixed share of the CPU the control loops run on. */
+/* ******************************************************************************* */
+
+#define DASHBOARD_TEXT_LENGTH 28  //mono20 is about 10 pixels a character, so 28 stays clear of the map
+
+enum DashboardText {
+  DASH_BATTERY, DASH_HEADING, DASH_POSE, DASH_TRACKERS, DASH_COLOR, DASH_DISTANCE, DASH_CONFIG, DASH_AUTON_TIME,
+  DASH_SELF_TEST, DASH_AUTON_LABEL, DASH_TEXT_COUNT
+};
+
+/// @brief Where a text widget is drawn (y is the text baseline)
+struct DashboardTextLayout {
+  int x;
+  int y;
+  fontType font;
+};
+
+constexpr DashboardTextLayout dashboardTextLayout[DASH_TEXT_COUNT] = {
+  {5, 20, fontType::mono20}, {5, 40, fontType::mono20}, {5, 60, fontType::mono20}, {5, 80, fontType::mono20},
+  {5, 100, fontType::mono20}, {5, 120, fontType::mono20}, {5, 140, fontType::mono20}, {5, 160, fontType::mono20},
+  {5, 180, fontType::mono20}, {5, 230, fontType::mono40},
+};
+
+//Field map in the top right: the 144" field at 1.25 pixels per inch, +Y up, 24" tiles
+const int dashboardMapLeft = 290;
+const int dashboardMapTop = 10;
+const int dashboardMapSize = 180;
+const int dashboardMapTiles = 6;
+const float dashboardFieldInches = 144.0;
+
+const uint32_t dashboardFrameBudgetMicros = 1500;  //Drawing stops for the frame after this long
+const int dashboardFrameMSec = 50;
+
+class Dashboard {
+public:
+  void setText(DashboardText id, const char* format, ...);
+  void setTextColor(DashboardText id, const color& fill);
+  void setPose(float X_position, float Y_position, float absolute_heading);
+  void invalidate();
+  void draw(uint32_t budgetMicros);
+
+  bool paused = false;  //Set while something else (like benchmark results) has the screen; draw() does nothing
+  uint32_t averageFrameMicros = 0;  //Drawing time per frame, averaged over about 8 frames
+
+private:
+  struct TextWidget {
+    char shown[DASHBOARD_TEXT_LENGTH + 1] = "";
+    char wanted[DASHBOARD_TEXT_LENGTH + 1] = "";
+    uint32_t fill = 0x000000;  //Background as 0xRRGGBB
+    bool dirty = false;
+  };
+  TextWidget texts[DASH_TEXT_COUNT];
+  int nextText = 0;  //Where the next frame starts looking, so a line that changes every frame can't starve the rest
+
+  bool clearPending = true;
+  bool robotDirty = false;
+  bool robotShown = false;
+  int shownX = 0, shownY = 0, shownTipX = 0, shownTipY = 0;  //Screen position of the marker as drawn
+  int wantedX = 0, wantedY = 0, wantedTipX = 0, wantedTipY = 0;
+
+  void drawText(int id);
+  void drawMapGrid(int left, int top, int right, int bottom);
+  void drawRobot();
+};
+
+extern Dashboard dashboard;
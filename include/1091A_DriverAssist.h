@@ -0,0 +1,33 @@
+#pragma once
+#include "v5.h"
+#include "v5_vcs.h"
+#include "1091A_DriverInput.h"
+
+using namespace vex;
+
+enum AssistMode { ASSIST_NONE, ASSIST_SNAP_HEADING, ASSIST_MOGO_ALIGN, ASSIST_DRIVE_TO_LADDER };
+
+/// @brief Driver assist modes that use the live odom pose and sensors to line the robot up.
+/// @brief Y tap snaps to the nearest 90 degree heading, Y hold drives to the ladder, A backs onto a mogo and clamps it.
+/// @brief Moving the sticks past the override threshold always hands the drive back to the driver.
+class DriverAssist {
+public:
+  AssistMode mode = ASSIST_NONE;
+
+  bool update(const DriverInput& input);
+  void cancel();
+
+private:
+  float snapTargetHeading = 0;
+  float snapPreviousError = 0;
+  double snapSettledMSec = 0;
+  vex::task ladderTask;
+  vex::task ladderArmTask;
+
+  void startSnapHeading(float currentHeading);
+  bool updateSnapHeading(const DriverInput& input);
+  void startMogoAlign();
+  bool updateMogoAlign(const DriverInput& input);
+  void startDriveToLadder();
+  bool updateDriveToLadder(const DriverInput& input);
+};
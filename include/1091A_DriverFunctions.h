@@ -3,10 +3,12 @@
 #include "v5.h"
 #include "v5_vcs.h"
 #include "vex_imu.h"
+#include "1091A_DriverInput.h"
 
 using namespace vex;
 
 //Mogo Functions
+extern const double mogoClampDistanceMM;  //Back distance sensor reading when the mogo is inside the clamp
 void clampMogo(void);
 void releaseMogo(void);
 
@@ -15,14 +17,22 @@ void lowerDoinker(void);
 void raiseDoinker(void);
 
 //Conveyor Functions
-void spinConveyorForward(void);
-void spinConveyorReverse(void);
+void updateConveyor(const DriverInput& input);
 
 //Arm Functions
 void gotoReceiveRingPosition(void);
-void rotateArmForward(void);
-void rotateArmBack(void);
 void lockRing(void);
+void updateArm(const DriverInput& input);
+
+//Pneumatics (mogo, doinker) and ring lock buttons
+void updatePneumatics(const DriverInput& input);
 
 //Color sorting Function
+bool isUnwantedRing(double hue);
 void checkAndFilterBadRing(void);
+
+//Controller screen status and rumble
+void updateDriverFeedback(const DriverInput& input);
+
+//Runs one usercontrol() tick of all the driver controlled mechanisms
+void updateDriverSubsystems(const DriverInput& input);
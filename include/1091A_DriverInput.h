@@ -0,0 +1,43 @@
+#pragma once
+#include "v5.h"
+#include "v5_vcs.h"
+
+using namespace vex;
+
+/// @brief State of one controller button for the current usercontrol() tick.
+/// @brief pressing is the level, pressed/released are the edges, heldMSec is how long it has been down
+/// @brief (still valid on the released tick).
+struct ButtonState {
+  bool pressing = false;
+  bool pressed = false;
+  bool released = false;
+  double heldMSec = 0.0;
+
+  /// @brief True while the button has been down for at least holdMSec
+  bool held(double holdMSec) const { return pressing && heldMSec >= holdMSec; }
+
+  /// @brief True only on the tick the hold time first reaches holdMSec
+  bool holdStarted(double holdMSec, double tickMSec) const { return held(holdMSec) && heldMSec - tickMSec < holdMSec; }
+
+  void update(bool isPressing, double tickMSec);
+};
+
+/// @brief Snapshot of the controller taken once per usercontrol() tick.
+/// @brief Everything in driver control reads buttons and sticks from here instead of polling Controller1,
+/// @brief so every subsystem sees the same inputs for the whole tick and nothing blocks waiting on a button.
+class DriverInput {
+public:
+  ButtonState L1, L2, R1, R2;
+  ButtonState Up, Down, Left, Right;
+  ButtonState X, B, Y, A;
+
+  int Axis1 = 0;
+  int Axis2 = 0;
+  int Axis3 = 0;
+  int Axis4 = 0;
+
+  double timeMSec = 0.0;  //Brain timer value (in msec) when this snapshot was taken
+  double tickMSec = 0.0;  //Time since the previous snapshot
+
+  void sample(controller& c);
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include "JAR-Template/motion_params.h"
+
+/* ******************************************************************************* */
+/* 1091A's tuned motion presets (used by the turn_to_heading_* and                 */
+/* drive_distance_* functions in autons.cpp). They are checked when this file is   */
+/* compiled, so a typo in a tuning value (a negative gain, 120 volts instead of    */
+/* 12) stops the build instead of showing up on the field. The autons run the      */
+/* copies in robotConfig, which start as these values and can be retuned on the    */
+/* robot or loaded from the SD card (see 1091A_ConfigStore.h).                     */
+/* ******************************************************************************* */
+
+/* Drive presets. The driving starti depends on the distance, so here it is the starti per inch driven and the
+   drive_distance_* functions multiply it by the distance when they run. */
+constexpr drive_params driveSmallPreset = {
+  /* driving volts, min volts, heading volts */ 11, 0, 6,
+  /* tolerance, settle time, timeout */ 0.1, 20, 3000,
+  /* Driving kp, ki, kd, starti per inch */ {0.95, 0.0, 2.5, 0.25},
+  /* Heading kp, ki, kd, heading starti */ {0.4, 0, 1, 0},
+  /* boomerang lead, setback (unused) */ 0, 0};
+
+constexpr drive_params driveMediumPreset = {
+  /* driving volts, min volts, heading volts */ 12, 0, 6,
+  /* tolerance, settle time, timeout */ 0.1, 150, 3000,
+  /* Driving kp, ki, kd, starti per inch */ {0.95, 0.2, 1.5, 0.25},
+  /* Heading kp, ki, kd, heading starti */ {0.4, 0, 1, 0},
+  /* boomerang lead, setback (unused) */ 0, 0};
+
+constexpr drive_params driveLargePreset = {
+  /* driving volts, min volts, heading volts */ 12, 0, 6,
+  /* tolerance, settle time, timeout */ 0.25, 300, 3000,
+  /* Driving kp, ki, kd, starti per inch */ {0.90, 0.0, 2.5, 0.1},
+  /* Heading kp, ki, kd, heading starti */ {0.4, 0, 1, 0},
+  /* boomerang lead, setback (unused) */ 0, 0};
+
+/* Turn presets. All of them use the turn engine in Drive::turn_to_angle() with the same gains; the size only picks
+   how hard we are allowed to push. The settle error is the tolerance each call passes in.
+   NOT TUNED YET: these gains are a starting point for the new engine. The old per-size gains (kp 0.68 to 1.0) were
+   tuned for the old turn loop and don't carry over. Retune on the robot with the PID TUNER. */
+constexpr pid_gains presetTurnGains = {0.35, 0.02, 1.2, 5};
+
+constexpr turn_params turnTinyPreset = {8.5, 1, 40, 2000, presetTurnGains};
+constexpr turn_params turnSmallPreset = {10.0, 1, 40, 2000, presetTurnGains};
+constexpr turn_params turnMediumPreset = {12, 1, 40, 2000, presetTurnGains};
+constexpr turn_params turnLargePreset = {12, 1, 40, 2000, presetTurnGains};
+constexpr turn_params turnXLargePreset = {12, 1, 40, 2000, presetTurnGains};
+constexpr turn_params adjustHeadingPreset = {4.0, 1, 40, 2000, presetTurnGains};
+
+enum TurnPresetId { TURN_PRESET_TINY, TURN_PRESET_SMALL, TURN_PRESET_MEDIUM, TURN_PRESET_LARGE, TURN_PRESET_XLARGE,
+  TURN_PRESET_ADJUST_HEADING, TURN_PRESET_COUNT };
+enum DrivePresetId { DRIVE_PRESET_SMALL, DRIVE_PRESET_MEDIUM, DRIVE_PRESET_LARGE, DRIVE_PRESET_COUNT };
+
+static_assert(valid_drive_params(driveSmallPreset), "driveSmallPreset is out of range");
+static_assert(valid_drive_params(driveMediumPreset), "driveMediumPreset is out of range");
+static_assert(valid_drive_params(driveLargePreset), "driveLargePreset is out of range");
+static_assert(valid_turn_params(turnTinyPreset), "turnTinyPreset is out of range");
+static_assert(valid_turn_params(turnSmallPreset), "turnSmallPreset is out of range");
+static_assert(valid_turn_params(turnMediumPreset), "turnMediumPreset is out of range");
+static_assert(valid_turn_params(turnLargePreset), "turnLargePreset is out of range");
+static_assert(valid_turn_params(turnXLargePreset), "turnXLargePreset is out of range");
+static_assert(valid_turn_params(adjustHeadingPreset), "adjustHeadingPreset is out of range");
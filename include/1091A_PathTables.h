@@ -0,0 +1,86 @@
+#pragma once
+#include "JAR-Template/trajectory.h"
+
+// Generated by tools/pathgen.cpp from paths/*.path. Do not edit; edit the .path files and rebuild.
+// Fields: time, distance, x, y, heading_deg, curvature, velocity, acceleration.
+
+// s_curve_test: paths/test.path, 35 points, 35.7 in, 1.10 s
+constexpr trajectory_point s_curve_test[] = {
+  {0.0f, 0.0f, 0.0f, 0.0f, 3.969262f, 0.0f, 0.0f, 150.0f},
+  {0.1197133f, 1.074846f, 0.07440225f, 1.072268f, 7.94347f, 0.1337652f, 17.957f, 84.78647f},
+  {0.17117f, 2.111101f, 0.291018f, 2.085629f, 16.00327f, 0.1346267f, 22.31983f, 84.54973f},
+  {0.2134822f, 3.131189f, 0.6399606f, 3.044179f, 23.72679f, 0.1269789f, 25.89732f, 86.69877f},
+  {0.2506668f, 4.154108f, 1.111344f, 3.952013f, 30.81811f, 0.1132568f, 29.12117f, 90.84149f},
+  {0.2846012f, 5.194621f, 1.695281f, 4.813224f, 37.10099f, 0.09672539f, 32.20382f, 96.39043f},
+  {0.3162784f, 6.263112f, 2.381886f, 5.63191f, 42.33054f, 0.08048972f, 35.25721f, 102.542f},
+  {0.3439986f, 7.279846f, 3.09825f, 6.353416f, 46.77714f, 0.06597688f, 38.09969f, 108.7456f},
+  {0.3705136f, 8.328283f, 3.885894f, 7.045397f, 50.35995f, 0.05364138f, 40.98307f, 114.6404f},
+  {0.3959727f, 9.408829f, 4.737042f, 7.711073f, 53.23629f, 0.04338361f, 43.90172f, 120.0521f},
+  {0.418463f, 10.42655f, 5.566406f, 8.300921f, 55.62153f, 0.03491436f, 46.60173f, 124.9213f},
+  {0.4401875f, 11.46843f, 6.436608f, 8.873853f, 57.48925f, 0.02788823f, 49.31557f, 129.2704f},
+  {0.4611754f, 12.53193f, 7.341658f, 9.43235f, 58.99809f, 0.02181992f, 52.02869f, 133.2783f},
+  {0.4814468f, 13.61401f, 8.275567f, 9.978894f, 60.18156f, 0.01650054f, 54.73043f, 137.0017f},
+  {0.501015f, 14.71122f, 9.232344f, 10.51596f, 61.03596f, 0.01188047f, 57.41131f, 140.4083f},
+  {0.5182017f, 15.71867f, 10.11695f, 10.99808f, 61.63499f, 0.007766852f, 59.82447f, 143.5876f},
+  {0.5348184f, 16.73257f, 11.011f, 11.47628f, 61.97599f, 0.004008956f, 62.21041f, 146.6203f},
+  {0.5508676f, 17.74988f, 11.91f, 11.95243f, 62.103f, 0.0003626961f, 64.56355f, -102.1436f},
+  {0.5668307f, 18.76751f, 12.80945f, 12.42839f, 62.01836f, -0.003275098f, 62.93302f, -144.1957f},
+  {0.5832657f, 19.78234f, 13.70485f, 12.90603f, 61.72053f, -0.007000521f, 60.56316f, -141.1342f},
+  {0.6002623f, 20.79132f, 14.59171f, 13.38721f, 61.20399f, -0.01092483f, 58.16436f, -137.8709f},
+  {0.6178231f, 21.79147f, 15.46551f, 13.8738f, 60.41195f, -0.01529976f, 55.74324f, -134.3195f},
+  {0.6377959f, 22.87803f, 16.40625f, 14.41751f, 59.35186f, -0.02030261f, 53.06049f, -130.3954f},
+  {0.6584656f, 23.94692f, 17.31976f, 14.9725f, 57.93479f, -0.02614741f, 50.36526f, -126.1446f},
+  {0.6798471f, 24.99497f, 18.20007f, 15.54125f, 56.16874f, -0.03288902f, 47.66811f, -121.3768f},
+  {0.7019625f, 26.01949f, 19.04116f, 16.12624f, 53.90228f, -0.04101232f, 44.9838f, -116.0684f},
+  {0.7269654f, 27.10794f, 19.90697f, 16.78585f, 51.15948f, -0.05084198f, 42.08175f, -110.2413f},
+  {0.7529559f, 28.16443f, 20.71122f, 17.47095f, 47.73272f, -0.06272203f, 39.21653f, -104.0474f},
+  {0.7800547f, 29.18895f, 21.44613f, 18.18477f, 43.46573f, -0.07680851f, 36.39696f, -97.8026f},
+  {0.8108951f, 30.26493f, 22.15502f, 18.99422f, 38.42782f, -0.0928175f, 33.38069f, -92.02117f},
+  {0.843722f, 31.31113f, 22.76353f, 19.84526f, 32.34366f, -0.1095756f, 30.35993f, -87.49638f},
+  {0.879339f, 32.33697f, 23.26177f, 20.74197f, 25.42785f, -0.1242358f, 27.24356f, -84.84513f},
+  {0.9192274f, 33.35617f, 23.63984f, 21.68845f, 17.82799f, -0.1335526f, 23.85923f, -84.64063f},
+  {0.9663653f, 34.38681f, 23.88788f, 22.6888f, 8.855927f, -0.1342956f, 19.86945f, -150.0f},
+  {1.098828f, 35.70279f, 24.0f, 24.0f, 4.887596f, 0.0f, 0.0f, 0.0f},
+};
+constexpr int s_curve_test_count = 35;
+
+// s_curve_test_reversed: paths/test.path, 35 points, 35.7 in, 1.10 s
+constexpr trajectory_point s_curve_test_reversed[] = {
+  {0.0f, 0.0f, 24.0f, 24.0f, 183.9693f, 0.0f, 0.0f, 150.0f},
+  {0.1197133f, 1.074846f, 23.9256f, 22.92773f, 187.9435f, 0.1337656f, 17.957f, 84.78639f},
+  {0.1711699f, 2.1111f, 23.70898f, 21.91437f, 196.0033f, 0.1346277f, 22.31982f, 84.54948f},
+  {0.2134822f, 3.131187f, 23.36004f, 20.95582f, 203.7268f, 0.1269771f, 25.8973f, 86.69923f},
+  {0.2506667f, 4.154106f, 22.88866f, 20.04799f, 210.8181f, 0.1132571f, 29.12117f, 90.84145f},
+  {0.2846011f, 5.194619f, 22.30472f, 19.18678f, 217.101f, 0.09672663f, 32.20382f, 96.38992f},
+  {0.3162784f, 6.26311f, 21.61811f, 18.36809f, 222.3306f, 0.08048889f, 35.25719f, 102.5424f},
+  {0.3439987f, 7.279847f, 20.90175f, 17.64658f, 226.7771f, 0.06597712f, 38.09969f, 108.7454f},
+  {0.3705135f, 8.328281f, 20.11411f, 16.95461f, 230.3599f, 0.05364043f, 40.98306f, 114.641f},
+  {0.3959727f, 9.408828f, 19.26296f, 16.28893f, 233.2363f, 0.04338439f, 43.90172f, 120.0518f},
+  {0.418463f, 10.42655f, 18.43359f, 15.69908f, 235.6216f, 0.03491491f, 46.60173f, 124.9207f},
+  {0.4401875f, 11.46843f, 17.56339f, 15.12615f, 237.4893f, 0.02788856f, 49.31556f, 129.2703f},
+  {0.4611753f, 12.53193f, 16.65834f, 14.56765f, 238.9981f, 0.02181825f, 52.02867f, 133.2793f},
+  {0.4814467f, 13.61401f, 15.72443f, 14.02111f, 240.1815f, 0.01650116f, 54.73043f, 137.0011f},
+  {0.501015f, 14.71122f, 14.76766f, 13.48404f, 241.0359f, 0.01188078f, 57.4113f, 140.4081f},
+  {0.5182017f, 15.71867f, 13.88305f, 13.00192f, 241.635f, 0.007766852f, 59.82446f, 143.5873f},
+  {0.5348184f, 16.73257f, 12.989f, 12.52372f, 241.976f, 0.00400855f, 62.2104f, 146.6205f},
+  {0.5508676f, 17.74988f, 12.09f, 12.04757f, 242.103f, 0.000362611f, 64.56355f, -102.1436f},
+  {0.5668307f, 18.76751f, 11.19055f, 11.57161f, 242.0184f, -0.003273854f, 62.93301f, -144.1944f},
+  {0.5832657f, 19.78234f, 10.29515f, 11.09397f, 241.7205f, -0.007002161f, 60.56317f, -141.1353f},
+  {0.6002623f, 20.79132f, 9.408294f, 10.61279f, 241.204f, -0.01092319f, 58.16436f, -137.8704f},
+  {0.6178231f, 21.79147f, 8.534489f, 10.1262f, 240.412f, -0.01530056f, 55.74324f, -134.32f},
+  {0.6377959f, 22.87803f, 7.59375f, 9.582487f, 239.3519f, -0.02030192f, 53.06049f, -130.3945f},
+  {0.6584656f, 23.94692f, 6.680237f, 9.027497f, 237.9348f, -0.02614882f, 50.36528f, -126.145f},
+  {0.6798471f, 24.99497f, 5.799934f, 8.458746f, 236.1687f, -0.032888f, 47.66811f, -121.3765f},
+  {0.7019625f, 26.01949f, 4.958841f, 7.873762f, 233.9023f, -0.04101276f, 44.98381f, -116.0687f},
+  {0.7269654f, 27.10794f, 4.093029f, 7.214154f, 231.1595f, -0.05084128f, 42.08176f, -110.241f},
+  {0.7529559f, 28.16443f, 3.288782f, 6.529055f, 227.7327f, -0.06272259f, 39.21654f, -104.0473f},
+  {0.7800547f, 29.18895f, 2.553869f, 5.815232f, 223.4657f, -0.07680907f, 36.39698f, -97.80294f},
+  {0.8108952f, 30.26493f, 1.844976f, 5.005777f, 218.4278f, -0.0928167f, 33.38069f, -92.02077f},
+  {0.8437221f, 31.31114f, 1.236468f, 4.154742f, 212.3436f, -0.1095767f, 30.35993f, -87.49689f},
+  {0.8793392f, 32.33697f, 0.7382326f, 3.258031f, 205.4278f, -0.1242342f, 27.24355f, -84.84477f},
+  {0.9192275f, 33.35617f, 0.360157f, 2.311547f, 197.828f, -0.1335538f, 23.85923f, -84.64072f},
+  {0.9663655f, 34.38681f, 0.1121235f, 1.311199f, 188.8559f, -0.1342952f, 19.86945f, -150.0f},
+  {1.098828f, 35.7028f, 0.0f, 0.0f, 184.8876f, 0.0f, 0.0f, 0.0f},
+};
+constexpr int s_curve_test_reversed_count = 35;
+
@@ -0,0 +1,39 @@
+#pragma once
+
+/* ******************************************************************************* */
+/* Pre-match self-test, run in pre_auton while the robot sits still. For about     */
+/* 1.5 seconds every sensor and motor is read every 10 msec and checked for:       */
+/*   unplugged     the port reports no device                                      */
+/*   stale         the device went too long without new data                       */
+/*   out of range  a reading above what the device can give (or a hot motor)      */
+/*   noisy         readings that jump around while nothing moves                   */
+/*   drifting      readings that creep while nothing moves                         */
+/* Failures are shown on the Brain dashboard and the controller, and printed to   */
+/* the console.                                                                    */
+/* ******************************************************************************* */
+
+enum SelfTestFault {
+  SELF_TEST_OK, SELF_TEST_UNPLUGGED, SELF_TEST_STALE, SELF_TEST_OUT_OF_RANGE, SELF_TEST_NOISY, SELF_TEST_DRIFTING
+};
+
+/// @brief What the self-test found for one device
+struct SelfTestReport {
+  const char* name;
+  SelfTestFault fault = SELF_TEST_OK;
+  float worstGapMSec = 0;  //Longest time without new data
+  float noise = 0;  //Standard deviation of the readings
+  float drift = 0;  //Last reading minus the first
+  float highest = 0;
+};
+
+const int selfTestMSec = 1500;
+const int selfTestSampleMSec = 10;
+const float selfTestMaxGapMSec = 100.0;  //Sensors send new data every 10 to 50 msec
+
+extern SelfTestReport selfTestReports[];
+extern const int selfTestDeviceCount;
+extern int selfTestFailures;
+
+int runSelfTest();
+const char* selfTestFaultText(SelfTestFault fault);
+void showSelfTest(double timeMSec);
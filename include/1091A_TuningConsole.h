@@ -0,0 +1,35 @@
+#pragma once
+#include "1091A_ConfigStore.h"
+
+/* ******************************************************************************* */
+/* PID tuning on the robot. Pick PID TUNER in the auton selector and start driver  */
+/* control: the controller edits the turn and drive presets, runs a test motion    */
+/* with them, and the Brain screen shows how it settled. SAVE writes the whole     */
+/* robotConfig to config.bin on the SD card (see 1091A_ConfigStore.h), which is    */
+/* loaded in pre_auton, so no rebuild is needed.                                   */
+/*                                                                                 */
+/*   L1 / L2       next / previous preset                                          */
+/*   Up / Down     previous / next value                                           */
+/*   Right / Left  raise / lower the value (hold to repeat)                        */
+/*   R1 / R2       step x10 / step /10                                             */
+/*   A             run the test motion (alternates out and back)                   */
+/*   X             put the preset back to its compiled-in values                   */
+/*   Y             save robotConfig to the SD card                                 */
+/*   B (hold)      leave the tuner and drive                                       */
+/* The Brain touchscreen can pick a value by tapping its row, and has RUN and SAVE */
+/* buttons.                                                                        */
+/* ******************************************************************************* */
+
+/// @brief How the last test motion went
+struct TuningResult {
+  bool valid = false;
+  float target = 0;  //Degrees for turns, inches for drives
+  float overshoot = 0;  //Furthest past the target, same units
+  float finalError = 0;
+  float settleMSec = 0;  //Time until the error entered the settle window for the last time
+  float totalMSec = 0;  //Time until the motion returned (includes the settle time and any timeout)
+};
+
+extern bool tuningConsoleActive;  //True while the tuner owns the Brain screen
+
+void tuning_console();
@@ -0,0 +1,139 @@
+#pragma once
+
+/**
+ * Odometry sources and holonomic motors for Drive.
+ * Each tracker type reads one tracking wheel in inches. TrackerOdom
+ * takes the forward and sideways tracker types as template arguments
+ * and runs the tracking loop for exactly that pair. The pair is picked
+ * in main.cpp, so the loop that runs every 5 msec has no check of the
+ * drive setup, and only the sensors the robot has are ever constructed.
+ */
+
+/**
+ * Rotation sensor tracking wheel.
+ */
+
+class RotationTracker
+{
+private:
+  vex::rotation sensor;
+  float in_to_deg_ratio;
+public:
+  float center_distance;
+  RotationTracker(int port, float diameter, float center_distance);
+  float position(){ return(sensor.position(vex::deg)*in_to_deg_ratio); }
+};
+
+/**
+ * Three wire encoder tracking wheel. The tracker holds its own handle
+ * to the Brain's triports (smart port 22) rather than using Brain's, so
+ * it can be a global in another file without depending on Brain being
+ * constructed first.
+ */
+
+class EncoderTracker
+{
+private:
+  vex::triport ThreeWire = vex::triport(vex::PORT22);
+  vex::encoder sensor;
+  float in_to_deg_ratio;
+public:
+  float center_distance;
+  EncoderTracker(int port, float diameter, float center_distance);
+  float position(){ return(sensor.position(vex::deg)*in_to_deg_ratio); }
+};
+
+/**
+ * One side of the drive used as the tracking wheel, for odom with
+ * zero trackers.
+ */
+
+class MotorTracker
+{
+private:
+  vex::motor_group motors;
+  float in_to_deg_ratio;
+public:
+  float center_distance;
+  MotorTracker(vex::motor_group motors, float wheel_diameter, float wheel_ratio, float center_distance);
+  float position(){ return(motors.position(vex::deg)*in_to_deg_ratio); }
+};
+
+/**
+ * No tracker in this direction. Always reads 0.
+ */
+
+class NoTracker
+{
+public:
+  float center_distance = 0;
+  float position(){ return(0); }
+};
+
+/**
+ * What Drive sees of its odometry. The tracker readings here are for
+ * the occasional caller (set_coordinates(), odom_test()); the
+ * tracking loop itself runs inside track() with the trackers inlined.
+ */
+
+class OdomSource
+{
+public:
+  float ForwardTracker_center_distance;
+  float SidewaysTracker_center_distance;
+  virtual float forward_position() = 0;
+  virtual float sideways_position() = 0;
+  virtual void track(Drive &drive) = 0;
+};
+
+/**
+ * Odometry from one forward and one sideways tracker.
+ *
+ * @tparam ForwardTracker RotationTracker, EncoderTracker, MotorTracker or NoTracker.
+ * @tparam SidewaysTracker RotationTracker, EncoderTracker, MotorTracker or NoTracker.
+ */
+
+template <typename ForwardTracker, typename SidewaysTracker>
+class TrackerOdom : public OdomSource
+{
+private:
+  ForwardTracker forward;
+  SidewaysTracker sideways;
+public:
+  TrackerOdom(const ForwardTracker &forward, const SidewaysTracker &sideways) :
+    forward(forward),
+    sideways(sideways)
+  {
+    ForwardTracker_center_distance = forward.center_distance;
+    SidewaysTracker_center_distance = sideways.center_distance;
+  }
+
+  float forward_position(){ return(forward.position()); }
+  float sideways_position(){ return(sideways.position()); }
+
+  /**
+   * Background tracking loop. Never returns.
+   */
+
+  void track(Drive &drive){
+    while(1){
+      drive.odom.update_position(forward.position(), sideways.position(), drive.get_absolute_heading());
+      vex::task::sleep(5);
+    }
+  }
+};
+
+/**
+ * The four corner motors of a holonomic drive. Only holonomic robots
+ * construct one and hand it to Drive.
+ */
+
+class HolonomicMotors
+{
+public:
+  vex::motor DriveLF;
+  vex::motor DriveRF;
+  vex::motor DriveLB;
+  vex::motor DriveRB;
+  HolonomicMotors(int DriveLF_port, int DriveRF_port, int DriveLB_port, int DriveRB_port);
+};
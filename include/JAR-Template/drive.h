@@ -1,13 +1,30 @@
 #pragma once
 #include "vex.h"
 
-enum drive_setup {ZERO_TRACKER_NO_ODOM, ZERO_TRACKER_ODOM, TANK_ONE_FORWARD_ENCODER, TANK_ONE_FORWARD_ROTATION, 
-TANK_ONE_SIDEWAYS_ENCODER, TANK_ONE_SIDEWAYS_ROTATION, TANK_TWO_ENCODER, TANK_TWO_ROTATION, 
-HOLONOMIC_TWO_ENCODER, HOLONOMIC_TWO_ROTATION};
+enum driver_curve {LINEAR_CURVE, EXPONENTIAL_CURVE, CUBIC_CURVE};
+
+enum odom_controller {PID_CONTROLLER, MPC_CONTROLLER};
+
+class PID;
+class OdomSource;
+class HolonomicMotors;
+
+/**
+ * Recent readings from one sensor used for relocalize_from_wall(), so
+ * a single reading off something that isn't the wall can't move odom.
+ * Keep one per sensor for as long as it is relocalizing.
+ */
+
+struct wall_reading_streak {
+  bool hits_end_wall = false;
+  float correction = 0;
+  int count = 0;
+};
 
 /**
  * Drive class supporting tank and holo drive, with or without odom.
- * Eight flavors of odom and six custom motion algorithms.
+ * The odom hardware comes in as an OdomSource (see chassis.h) and
+ * holonomic drives add their corner motors as a HolonomicMotors.
  */
 
 class Drive
@@ -17,27 +34,36 @@ private:
   float wheel_ratio;
   float gyro_scale;
   float drive_in_to_deg_ratio;
-  float ForwardTracker_center_distance;
-  float ForwardTracker_diameter;
-  float ForwardTracker_in_to_deg_ratio;
-  float SidewaysTracker_center_distance;
-  float SidewaysTracker_diameter;
-  float SidewaysTracker_in_to_deg_ratio;
-  vex:: triport ThreeWire = vex::triport(vex::PORT22);
+  OdomSource &odom_source;
+  HolonomicMotors *holonomic_motors = NULL;
+  bool heading_hold_active = false;
+  float heading_hold_target = 0;
+  float heading_hold_prev_heading = 0;
+  float heading_hold_prev_error = 0;
+  double heading_hold_prev_time = -1;
+  float heading_rate = 0;
+  float heading_rate_prev_rotation = 0;
+  double heading_rate_prev_time = -1;
+  float shape_driver_input(float input, driver_curve curve, float curve_gain);
+  float straight_heading_correction(PID& headingPID, float heading, float heading_max_voltage);
+  bool stall_terminator_armed = false;
+  float stall_velocity;
+  float stall_time;
+  bool current_terminator_armed = false;
+  float current_limit;
+  float current_time;
+  vex::distance* distance_terminator_sensor = NULL;
+  float distance_terminator_mm;
+  double terminator_motion_start = -1;
+  double stall_started = -1;
+  double current_started = -1;
+  void swing_motion(float angle, float inner_ratio, bool reversed, float swing_exit_error, const turn_params &params);
+  void mpc_motion(float X_position, float Y_position, bool use_angle, float angle, float drive_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout);
 
 public: 
-  drive_setup drive_setup = ZERO_TRACKER_NO_ODOM;
   motor_group DriveL;
   motor_group DriveR;
   inertial Gyro;
-  motor DriveLF;
-  motor DriveRF;
-  motor DriveLB;
-  motor DriveRB;
-  rotation R_ForwardTracker;
-  rotation R_SidewaysTracker;
-  encoder E_ForwardTracker;
-  encoder E_SidewaysTracker;
 
   float turn_max_voltage;
   float turn_kp;
@@ -49,6 +75,12 @@ public:
   float turn_settle_time;
   float turn_timeout;
 
+  float turn_max_rate = 540;
+  float turn_max_accel = 2400;
+  float turn_precision_window = 4;
+  float turn_precision_min_voltage = 1.5;
+  float turn_loop_period = 10;
+
   float drive_min_voltage;
   float drive_max_voltage;
   float drive_kp;
@@ -66,6 +98,9 @@ public:
   float heading_kd;
   float heading_starti;
 
+  float heading_rate_per_volt = 0;
+  float heading_rate_kp = 0;
+
   float swing_max_voltage;
   float swing_kp;
   float swing_ki;
@@ -76,14 +111,47 @@ public:
   float swing_settle_time;
   float swing_timeout;
 
+  float swing_max_rate = 360;
+  float swing_max_accel = 1200;
+
   float boomerang_lead;
   float boomerang_setback;
 
-  Drive(enum::drive_setup drive_setup, motor_group DriveL, motor_group DriveR, int gyro_port, float wheel_diameter, float wheel_ratio, float gyro_scale, int DriveLF_port, int DriveRF_port, int DriveLB_port, int DriveRB_port, int ForwardTracker_port, float ForwardTracker_diameter, float ForwardTracker_center_distance, int SidewaysTracker_port, float SidewaysTracker_diameter, float SidewaysTracker_center_distance);
+  float max_wheel_speed = 0;
+  float max_wheel_accel = 0;
+  float track_width = 0;
+  float wheel_accel_voltage = 0;
+  odom_controller point_controller = PID_CONTROLLER;
+  MPC mpc;
+
+  float max_centripetal_accel = 0;
+  float ramsete_beta = 0.0013;
+  float ramsete_zeta = 0.7;
+
+  float driver_deadband = 5;
+  float driver_turn_scale = 1;
+  driver_curve throttle_curve = LINEAR_CURVE;
+  float throttle_curve_gain = 0;
+  driver_curve turn_curve = LINEAR_CURVE;
+  float turn_curve_gain = 0;
+
+  bool heading_hold_enabled = false;
+  float heading_hold_max_voltage;
+  float heading_hold_kp;
+  float heading_hold_kd;
+  float heading_hold_latency;
+
+  Drive(motor_group DriveL, motor_group DriveR, int gyro_port, float wheel_diameter, float wheel_ratio, float gyro_scale, OdomSource &odom_source);
+  Drive(motor_group DriveL, motor_group DriveR, int gyro_port, float wheel_diameter, float wheel_ratio, float gyro_scale, OdomSource &odom_source, HolonomicMotors &holonomic_motors);
 
   void drive_with_voltage(float leftVoltage, float rightVoltage);
+  void drive_with_turn_voltage(float drive_voltage, float turn_voltage);
+  void drive_with_side_voltages(float clockwise_side_voltage, float counterclockwise_side_voltage);
+  motor_group& clockwise_side();
+  motor_group& counterclockwise_side();
 
   float get_absolute_heading();
+  float get_heading_rate();
 
   float get_left_position_in();
 
@@ -92,27 +160,48 @@ public:
   void set_turn_constants(float turn_max_voltage, float turn_kp, float turn_ki, float turn_kd, float turn_starti); 
   void set_drive_constants(float drive_max_voltage, float drive_kp, float drive_ki, float drive_kd, float drive_starti);
   void set_heading_constants(float heading_max_voltage, float heading_kp, float heading_ki, float heading_kd, float heading_starti);
+  void set_turn_profile_constants(float turn_max_rate, float turn_max_accel, float turn_precision_window, float turn_precision_min_voltage);
+  void set_heading_rate_constants(float heading_rate_per_volt, float heading_rate_kp);
   void set_swing_constants(float swing_max_voltage, float swing_kp, float swing_ki, float swing_kd, float swing_starti);
+  void set_swing_profile_constants(float swing_max_rate, float swing_max_accel);
+  void set_driver_constants(float driver_deadband, float driver_turn_scale);
+  void set_driver_curves(driver_curve throttle_curve, float throttle_curve_gain, driver_curve turn_curve, float turn_curve_gain);
+  void set_heading_hold_constants(float heading_hold_max_voltage, float heading_hold_kp, float heading_hold_kd, float heading_hold_latency);
+  void set_drive_model_constants(float max_wheel_speed, float max_wheel_accel, float track_width, float wheel_accel_voltage);
+  void set_trajectory_constants(float max_centripetal_accel, float ramsete_beta, float ramsete_zeta);
 
   void set_turn_exit_conditions(float turn_settle_error, float turn_settle_time, float turn_timeout);
   void set_drive_exit_conditions(float drive_settle_error, float drive_settle_time, float drive_timeout);
   void set_swing_exit_conditions(float swing_settle_error, float swing_settle_time, float swing_timeout);
 
+  drive_params default_drive_params();
+  turn_params default_turn_params();
+  turn_params default_swing_params();
+
   void turn_to_angle(float angle);
   void turn_to_angle(float angle, float turn_max_voltage);
   void turn_to_angle(float angle, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout);
   void turn_to_angle(float angle, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout, float turn_kp, float turn_ki, float turn_kd, float turn_starti);
+  void turn_to_angle(float angle, const turn_params &params);
 
   void drive_distance(float distance);
   void drive_distance(float distance, float heading);
   void drive_distance(float distance, float heading, float drive_max_voltage, float heading_max_voltage);
   void drive_distance(float distance, float heading, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout);
   void drive_distance(float distance, float heading, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti);
+  void drive_distance(float distance, float heading, const drive_params &params);
 
   void left_swing_to_angle(float angle);
   void left_swing_to_angle(float angle, float swing_max_voltage, float swing_settle_error, float swing_settle_time, float swing_timeout, float swing_kp, float swing_ki, float swing_kd, float swing_starti);
+  void left_swing_to_angle(float angle, const turn_params &params);
   void right_swing_to_angle(float angle);
   void right_swing_to_angle(float angle, float swing_max_voltage, float swing_settle_error, float swing_settle_time, float swing_timeout, float swing_kp, float swing_ki, float swing_kd, float swing_starti);
+  void right_swing_to_angle(float angle, const turn_params &params);
+  void swing_arc_to_angle(float angle, float radius);
+  void swing_arc_to_angle(float angle, float radius, bool reversed);
+  void swing_arc_to_angle(float angle, float radius, bool reversed, float swing_exit_error);
+  void swing_arc_to_angle(float angle, float radius, bool reversed, float swing_exit_error, float swing_max_voltage, float swing_settle_error, float swing_settle_time, float swing_timeout, float swing_kp, float swing_ki, float swing_kd, float swing_starti);
+  void swing_arc_to_angle(float angle, float radius, bool reversed, float swing_exit_error, const turn_params &params);
   
   Odom odom;
   float get_ForwardTracker_position();
@@ -122,44 +211,78 @@ public:
   void position_track();
   static int position_track_task();
   vex::task odom_task;
+  bool odom_started = false;
   float get_X_position();
   float get_Y_position();
 
+  float field_half_width = 70.2;
+  float relocalize_max_incidence = 20;
+  float relocalize_max_correction = 6;
+  float relocalize_agreement = 1;
+  int relocalize_agreeing_readings = 3;
+  float relocalize_stake_clearance = 10;
+  float relocalize_corner_clearance = 14;
+  void set_relocalize_constants(float field_half_width, float relocalize_max_incidence, float relocalize_max_correction);
+  void set_relocalize_filter_constants(float relocalize_agreement, int relocalize_agreeing_readings, float relocalize_stake_clearance, float relocalize_corner_clearance);
+  bool relocalize_from_wall(vex::distance &sensor, float sensor_forward_offset, float sensor_sideways_offset, bool sensor_faces_forward, float correction_gain, wall_reading_streak &streak);
+
   void drive_stop(vex::brakeType mode);
 
+  float terminator_grace_time = 150;
+  bool terminated_on_contact = false;
+  void stop_on_stall(float stall_velocity, float stall_time);
+  void stop_on_current(float current_limit, float current_time);
+  void stop_on_distance(vex::distance &sensor, float distance_mm);
+  bool motion_terminated();
+  void clear_terminators();
+  void drive_until_contact(float voltage, float timeout);
+
   void drive_to_point(float X_position, float Y_position);
   void drive_to_point(float X_position, float Y_position, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage);
   void drive_to_point(float X_position, float Y_position, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout);
   void drive_to_point(float X_position, float Y_position, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti);
+  void drive_to_point(float X_position, float Y_position, const drive_params &params);
   
   void drive_to_pose(float X_position, float Y_position, float angle);
   void drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage);
   void drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage);
   void drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout);
   void drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti);
+  void drive_to_pose(float X_position, float Y_position, float angle, const drive_params &params);
   
+  void drive_to_point_mpc(float X_position, float Y_position);
+  void drive_to_point_mpc(float X_position, float Y_position, float drive_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout);
+  void drive_to_pose_mpc(float X_position, float Y_position, float angle);
+  void drive_to_pose_mpc(float X_position, float Y_position, float angle, float drive_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout);
+
+  int plan_trajectory(const path_point *points, int point_count, trajectory_point *trajectory);
+  void follow_trajectory(const trajectory_point *trajectory, int point_count, bool reversed);
+
   void turn_to_point(float X_position, float Y_position);
   void turn_to_point(float X_position, float Y_position, float extra_angle_deg);
   void turn_to_point(float X_position, float Y_position, float extra_angle_deg, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout);
   void turn_to_point(float X_position, float Y_position, float extra_angle_deg, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout, float turn_kp, float turn_ki, float turn_kd, float turn_starti);
+  void turn_to_point(float X_position, float Y_position, float extra_angle_deg, const turn_params &params);
   
   void holonomic_drive_to_pose(float X_position, float Y_position);
   void holonomic_drive_to_pose(float X_position, float Y_position, float angle);
   void holonomic_drive_to_pose(float X_position, float Y_position, float angle, float drive_max_voltage, float heading_max_voltage);
   void holonomic_drive_to_pose(float X_position, float Y_position, float angle, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout);
   void holonomic_drive_to_pose(float X_position, float Y_position, float angle, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti);
+  void holonomic_drive_to_pose(float X_position, float Y_position, float angle, const drive_params &params);
 
   void control_arcade();
+  void control_arcade(float throttle_input, float turn_input);
   void control_tank();
   void control_holonomic();
 
   /* 1091A specific implementations */
-  void turn_to_heading_1091A(float targetHeading);
-  void turn_to_heading_1091A(float targetHeading, float turn_max_voltage, float turn_settle_error, float turn_timeout, float turn_kp, float turn_ki, float turn_kd, float turn_starti);
   //void turn_to_heading_1091A_IQBase(float targetHeading, float turn_max_voltage, float turn_settle_error, float turn_timeout, float turn_kp, float turn_ki, float turn_kd, float turn_starti);
 
-  void inline drive_distance_1091A(float distance) {drive_distance_1091A(distance, get_absolute_heading(), drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti); }
+  void inline drive_distance_1091A(float distance) {drive_distance_1091A(distance, get_absolute_heading(), default_drive_params()); }
   void inline drive_distance_1091A(float distance, float drive_max_voltage, float drive_settle_error, float drive_settle_time, float drive_kp, float drive_ki, float drive_kd, float drive_starti)
-    {drive_distance_1091A(distance, get_absolute_heading(), drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti); }
+    {drive_distance_1091A(distance, get_absolute_heading(), default_drive_params().with_max_voltage(drive_max_voltage).with_exit(drive_settle_error, drive_settle_time, drive_timeout).with_drive_gains({drive_kp, drive_ki, drive_kd, drive_starti})); }
   void drive_distance_1091A(float distance, float heading, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti);
+  void drive_distance_1091A(float distance, float heading, const drive_params &params);
+  bool back_to_contact_1091A(vex::distance &sensor, float contact_mm, float trigger_lead_msec, float max_voltage, float braking_decel, float timeout, float max_travel, void (*on_contact)());
 };
@@ -0,0 +1,105 @@
+#pragma once
+#include <math.h>
+
+/**
+ * Header-only angle kernels for the control loops. Everything here is
+ * inline and has no vex dependencies, so it can also be built and
+ * benchmarked on a PC (see tools/bench_fast_math.cpp).
+ */
+
+/**
+ * Wraps an angle into [lower, lower+period) in constant time, however
+ * many turns away it starts. The two compares only catch the last bit of
+ * float rounding at the ends of the range and compile to conditional
+ * moves, not loops.
+ *
+ * @param angle The angle to be wrapped.
+ * @param lower Bottom of the range (included).
+ * @param period Width of the range.
+ * @return Wrapped angle.
+ */
+
+inline float wrap_angle(float angle, float lower, float period){
+  angle -= period*floorf((angle-lower)/period);
+  if(angle >= lower+period) { angle -= period; }
+  if(angle < lower) { angle += period; }
+  return(angle);
+}
+
+/**
+ * Sine and cosine of a small angle, |r| <= pi/4.
+ * Taylor series to the x^7 (sine) and x^8 (cosine) terms. The first
+ * dropped terms are under 3.2e-7 and 2.5e-8 on that range.
+ */
+
+inline void fast_sincos_kernel(float r, float &sin_out, float &cos_out){
+  float r2 = r*r;
+  sin_out = r*(1.0f + r2*(-1.0f/6 + r2*(1.0f/120 + r2*(-1.0f/5040))));
+  cos_out = 1.0f + r2*(-0.5f + r2*(1.0f/24 + r2*(-1.0f/720 + r2*(1.0f/40320))));
+}
+
+/**
+ * Puts the kernel result in the right quadrant. Quarter turn q means the
+ * angle was r + q*90 degrees.
+ */
+
+inline void fast_sincos_quadrant(int quadrant, float s, float c, float &sin_out, float &cos_out){
+  switch(quadrant & 3){
+    case 0: sin_out = s;  cos_out = c;  break;
+    case 1: sin_out = c;  cos_out = -s; break;
+    case 2: sin_out = -s; cos_out = -c; break;
+    default: sin_out = -c; cos_out = s; break;
+  }
+}
+
+/**
+ * Sine and cosine of an angle in degrees, computed together.
+ * The angle is reduced to the nearest quarter turn in degrees, where 90 is
+ * exact in float, so there is no pi rounding in the reduction. Max error
+ * against double precision is about 3.1e-7 for |angle| up to 1e5 degrees
+ * (measured by tools/bench_fast_math.cpp).
+ *
+ * @param angle_deg The angle in degrees.
+ * @param sin_out Sine of the angle.
+ * @param cos_out Cosine of the angle.
+ */
+
+inline void fast_sincos_deg(float angle_deg, float &sin_out, float &cos_out){
+  int quadrant = static_cast<int>(angle_deg*(1.0f/90) + (angle_deg >= 0 ? 0.5f : -0.5f));
+  float r = (angle_deg - 90.0f*quadrant)*static_cast<float>(M_PI/180.0);
+  float s, c;
+  fast_sincos_kernel(r, s, c);
+  fast_sincos_quadrant(quadrant, s, c, sin_out, cos_out);
+}
+
+/**
+ * Sine and cosine of an angle in radians, computed together.
+ * The quarter turn is taken off in double precision (one multiply-add on
+ * the V5's FPU) so the reduction does not lose the low bits of pi. Max
+ * error against double precision is about 3.7e-7 for |angle| up to 1e3
+ * radians (measured by tools/bench_fast_math.cpp).
+ *
+ * @param angle_rad The angle in radians.
+ * @param sin_out Sine of the angle.
+ * @param cos_out Cosine of the angle.
+ */
+
+inline void fast_sincos(float angle_rad, float &sin_out, float &cos_out){
+  int quadrant = static_cast<int>(angle_rad*static_cast<float>(2.0/M_PI) + (angle_rad >= 0 ? 0.5f : -0.5f));
+  float r = static_cast<float>(angle_rad - quadrant*(M_PI/2));
+  float s, c;
+  fast_sincos_kernel(r, s, c);
+  fast_sincos_quadrant(quadrant, s, c, sin_out, cos_out);
+}
+
+inline float fast_sin(float angle_rad){
+  float s, c;
+  fast_sincos(angle_rad, s, c);
+  return(s);
+}
+
+inline float fast_cos(float angle_rad){
+  float s, c;
+  fast_sincos(angle_rad, s, c);
+  return(c);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+ * Parameter sets for the Drive motions. A motion takes one of these by
+ * const reference instead of a long list of floats. Start from the
+ * Drive's defaults (default_drive_params() and friends) or a constexpr
+ * preset, and change what the motion needs with the with_*() builders:
+ *
+ *   chassis.drive_to_pose(24, 48, 90, chassis.default_drive_params().with_max_voltage(8).with_boomerang(0.4, 2));
+ *
+ * Presets can be checked when they are compiled with
+ * static_assert(valid_drive_params(preset), "...").
+ */
+
+struct pid_gains {
+  float kp;
+  float ki;
+  float kd;
+  float starti;  // Error below which the integral runs
+};
+
+/**
+ * Straight drives, point and pose moves. The drive gains work on inches
+ * and the heading gains on degrees.
+ */
+
+struct drive_params {
+  float max_voltage;
+  float min_voltage;          // Least drive voltage, for chaining point and pose moves
+  float heading_max_voltage;
+  float settle_error;         // Inches
+  float settle_time;          // Milliseconds
+  float timeout;              // Milliseconds, 0 for none
+  pid_gains drive;
+  pid_gains heading;
+  float lead;                 // drive_to_pose() carrot lead
+  float setback;              // drive_to_pose() carrot setback in inches
+
+  drive_params with_max_voltage(float max_voltage) const { drive_params p = *this; p.max_voltage = max_voltage; return(p); }
+  drive_params with_min_voltage(float min_voltage) const { drive_params p = *this; p.min_voltage = min_voltage; return(p); }
+  drive_params with_heading_max_voltage(float heading_max_voltage) const { drive_params p = *this; p.heading_max_voltage = heading_max_voltage; return(p); }
+  drive_params with_exit(float settle_error, float settle_time, float timeout) const {
+    drive_params p = *this; p.settle_error = settle_error; p.settle_time = settle_time; p.timeout = timeout; return(p);
+  }
+  drive_params with_drive_gains(const pid_gains &drive) const { drive_params p = *this; p.drive = drive; return(p); }
+  drive_params with_drive_starti(float starti) const { drive_params p = *this; p.drive.starti = starti; return(p); }
+  drive_params with_heading_gains(const pid_gains &heading) const { drive_params p = *this; p.heading = heading; return(p); }
+  drive_params with_boomerang(float lead, float setback) const { drive_params p = *this; p.lead = lead; p.setback = setback; return(p); }
+};
+
+/**
+ * Turns and swings. The gains work on degrees.
+ */
+
+struct turn_params {
+  float max_voltage;
+  float settle_error;         // Degrees
+  float settle_time;          // Milliseconds
+  float timeout;              // Milliseconds, 0 for none
+  pid_gains gains;
+
+  turn_params with_max_voltage(float max_voltage) const { turn_params p = *this; p.max_voltage = max_voltage; return(p); }
+  turn_params with_settle_error(float settle_error) const { turn_params p = *this; p.settle_error = settle_error; return(p); }
+  turn_params with_exit(float settle_error, float settle_time, float timeout) const {
+    turn_params p = *this; p.settle_error = settle_error; p.settle_time = settle_time; p.timeout = timeout; return(p);
+  }
+  turn_params with_gains(const pid_gains &gains) const { turn_params p = *this; p.gains = gains; return(p); }
+};
+
+constexpr bool valid_voltage(float voltage){
+  return(voltage > 0 && voltage <= 12);
+}
+
+constexpr bool valid_gains(const pid_gains &gains){
+  return(gains.kp >= 0 && gains.ki >= 0 && gains.kd >= 0 && gains.starti >= 0);
+}
+
+/**
+ * Whether a drive parameter set makes sense: voltages within 12 with the
+ * minimum under the maximum, a settle window, no negative times or gains,
+ * and a lead from 0 to 1.
+ */
+
+constexpr bool valid_drive_params(const drive_params &p){
+  return(valid_voltage(p.max_voltage) && valid_voltage(p.heading_max_voltage) &&
+    p.min_voltage >= 0 && p.min_voltage <= p.max_voltage &&
+    p.settle_error > 0 && p.settle_time >= 0 && p.timeout >= 0 &&
+    valid_gains(p.drive) && valid_gains(p.heading) &&
+    p.lead >= 0 && p.lead <= 1 && p.setback >= 0);
+}
+
+/**
+ * Whether a turn or swing parameter set makes sense: a voltage within 12,
+ * a settle window, and no negative times or gains.
+ */
+
+constexpr bool valid_turn_params(const turn_params &p){
+  return(valid_voltage(p.max_voltage) && p.settle_error > 0 && p.settle_time >= 0 && p.timeout >= 0 && valid_gains(p.gains));
+}
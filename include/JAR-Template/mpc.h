@@ -0,0 +1,64 @@
+#pragma once
+
+#define MPC_HORIZON 12
+#define MPC_VARIABLES (2*MPC_HORIZON)
+#define MPC_CONSTRAINTS (4*MPC_HORIZON)
+
+/**
+ * Model-predictive controller for differential drive point and pose moves.
+ * Plans forward speed and turn rate over a short horizon with a unicycle
+ * model linearized about the last plan, under wheel speed and wheel
+ * acceleration limits, and returns the first step. The plan is a small
+ * quadratic program solved in fixed-size arrays (no heap) by qp_solve().
+ * The outputs are wheel speeds (in/s) and accelerations (in/s^2) for the
+ * next update_period, ramped so neither side breaks the acceleration
+ * limit. Positions are in the odom frame.
+ */
+
+class MPC
+{
+public:
+  float step_time = 0.06;
+  float max_wheel_speed = 0;
+  float max_wheel_accel = 0;
+  float track_width = 0;
+
+  float position_weight = 1;
+  float cross_track_weight = 4;
+  float heading_weight = 400;
+  float heading_blend_distance = 12;
+  float turn_weight = 0.05;
+  float smoothing_weight = 0.002;
+  int solver_iterations = 40;
+
+  float speed_limit = 0;
+  float update_period = 10;
+
+  float left_speed = 0;
+  float right_speed = 0;
+  float left_accel = 0;
+  float right_accel = 0;
+
+  MPC();
+
+  void set_model(float max_wheel_speed, float max_wheel_accel, float track_width);
+  void reset(float left_speed, float right_speed);
+  void compute(float X_position, float Y_position, float heading_deg, float target_X, float target_Y);
+  void compute(float X_position, float Y_position, float heading_deg, float target_X, float target_Y, float target_angle_deg);
+
+private:
+  float plan[MPC_VARIABLES];
+  float hessian[MPC_VARIABLES*MPC_VARIABLES];
+  float gradient[MPC_VARIABLES];
+  int constraint_rows[MPC_CONSTRAINTS+1];
+  int constraint_columns[4*MPC_CONSTRAINTS];
+  float constraint_values[4*MPC_CONSTRAINTS];
+  float lower_bounds[MPC_CONSTRAINTS];
+  float upper_bounds[MPC_CONSTRAINTS];
+  float qp_work[MPC_VARIABLES*MPC_VARIABLES + 2*MPC_CONSTRAINTS + 2*MPC_VARIABLES];
+
+  void build_constraints();
+  void solve(float X_position, float Y_position, float heading_deg, float target_X, float target_Y, bool use_angle, float target_angle_deg);
+};
+
+void qp_solve(int variable_count, int constraint_count, const float *hessian, const float *gradient, const int *row_start, const int *columns, const float *values, const float *lower_bounds, const float *upper_bounds, float *solution, int iterations, float *work);
@@ -11,11 +11,14 @@ private:
   float SidewaysTracker_center_distance;
   float ForwardTracker_position;
   float SideWaysTracker_position;
+  double X_position_sum = 0;
+  double Y_position_sum = 0;
 public:
   float X_position;
   float Y_position;
   float orientation_deg;
   void set_position(float X_position, float Y_position, float orientation_deg, float ForwardTracker_position, float SidewaysTracker_position);
   void update_position(float ForwardTracker_position, float SidewaysTracker_position, float orientation_deg);
+  void correct_position(float X_correction, float Y_correction);
   void set_physical_distances(float ForwardTracker_center_distance, float SidewaysTracker_center_distance);
 };
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * Time-optimal trajectories for a differential drive. A path is a list of
+ * points about evenly spaced along it; plan_trajectory() gives each point
+ * the fastest speed the robot can hold there (wheel speed, wheel
+ * acceleration and centripetal limits) and the time it is reached.
+ * Nothing here depends on vex, so the same code can run on a PC to
+ * build trajectories ahead of time. Positions are in the odom frame:
+ * inches, heading 0 = +Y, clockwise-positive, and positive curvature
+ * turns clockwise.
+ */
+
+struct path_waypoint {
+  float x;
+  float y;
+  float heading_deg;  // Direction of travel through the waypoint
+};
+
+struct path_point {
+  float x;
+  float y;
+};
+
+struct trajectory_point {
+  float time;          // Seconds from the start
+  float distance;      // Inches along the path
+  float x;
+  float y;
+  float heading_deg;
+  float curvature;     // 1/inches, positive turns clockwise
+  float velocity;      // in/s along the path
+  float acceleration;  // in/s^2 along the path, until the next point
+};
+
+struct trajectory_constraints {
+  float max_wheel_speed;        // in/s, either wheel
+  float max_wheel_accel;        // in/s^2, either wheel
+  float max_centripetal_accel;  // in/s^2, 0 for no limit
+  float track_width;            // inches between the wheels
+  float start_velocity;         // in/s at the first point
+  float end_velocity;           // in/s at the last point
+};
+
+int sample_path(const path_waypoint *waypoints, int waypoint_count, float spacing, path_point *points, int max_points);
+
+int plan_trajectory(const path_point *points, int point_count, const trajectory_constraints &constraints, trajectory_point *trajectory);
+
+trajectory_point sample_trajectory(const trajectory_point *trajectory, int point_count, float time);
@@ -18,10 +18,16 @@ int to_port(int port);
 
 float deadband(float input, float width);
 
+float exponential_curve(float input, float curve_gain);
+
+float cubic_curve(float input, float weight);
+
 bool is_line_settled(float desired_X, float desired_Y, float desired_angle, float current_X, float current_Y);
 
 float left_voltage_scaling(float drive_output, float heading_output);
 
 float right_voltage_scaling(float drive_output, float heading_output);
 
-float clamp_min_voltage(float drive_output, float drive_min_voltage);
\ No newline at end of file
+float clamp_min_voltage(float drive_output, float drive_min_voltage);
+
+bool trapezoidal_profile(float distance, float max_velocity, float max_acceleration, float time, float &position, float &velocity);
\ No newline at end of file
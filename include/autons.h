@@ -9,6 +9,8 @@ void default_constants();
 
 void drive_test();
 void turn_test();
+void benchmark_test();
+void path_test();
 void swing_test();
 void full_test();
 void odom_test();
@@ -21,6 +23,20 @@ void red_wp_auto(bool doLadderDrive);
 void blue_wp_auto(bool doLadderDrive);
 void red_right_qual_nopid_auto();
 void blue_left_qual_nopid_auto();
+void red_wp_qual_auto();
+void red_wp_elims_auto();
+void blue_wp_qual_auto();
+void blue_wp_elims_auto();
+void sd_script_auto();
+void no_auton();
+
+void setup_auto();
+void setup_auto(float start_X, float start_Y, bool isStartKnown);
+void shoot_alliance_ring();
+bool acquire_mogo();
+int relocalizeTask();
+int spinArmUpForLadder();
+int spinArmBackDown();
 
 /* ************************************ */
 /* Bunch of pre-tuned Driving functions */
@@ -32,18 +48,18 @@ void drive_distance_medium(float distance);
 void drive_distance_large(float distance);
 
 /* ********************************* */
-/* Bunch of pre-tuned turn functions */
+/* Bunch of turn preset functions    */
 /* ********************************* */
-//Use for tiny turns (less than 30 degrees) - This is not yet tuned
-void turn_to_heading_tiny(float targetHeading);
-//Use for small turns (30-60 degrees) - Tuned to 45
-void turn_to_heading_small(float targetHeading);
+//Use for tiny turns (less than 30 degrees)
+void turn_to_heading_tiny(float targetHeading, float tolerance = 1.0);
+//Use for small turns (30-60 degrees)
+void turn_to_heading_small(float targetHeading, float tolerance = 1.0);
 //Use for medium turns (60-120 degrees)
-void turn_to_heading_medium(float targetHeading);
+void turn_to_heading_medium(float targetHeading, float tolerance = 1.0);
 //Use for large turns (120-150 degrees)
-void turn_to_heading_large(float targetHeading);
+void turn_to_heading_large(float targetHeading, float tolerance = 1.0);
 //Use for x-large turns (> 150 degrees)
-void turn_to_heading_xlarge(float targetHeading);
+void turn_to_heading_xlarge(float targetHeading, float tolerance = 1.0);
 
-// Adjust heading after turning (call for situations when accuracy matters a lot)
+// Short low voltage turn to fix the heading after something knocked the robot off it (turns already end in tolerance)
 void adjustHeading(double targetHeading, double tolerance, double timeout);
\ No newline at end of file
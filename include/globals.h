@@ -3,3 +3,5 @@ extern bool userControl_started;
 extern double autonStartTime;
 extern int current_auton_selection;
 extern bool rejectRedRings;
+extern bool fieldPoseKnown;
+extern bool relocalizeRequested;
\ No newline at end of file
@@ -20,12 +20,28 @@
 #include "vex_imu.h"
 
 #include "robot-config.h"
+#include "JAR-Template/fast_math.h"
+#include "JAR-Template/mpc.h"
+#include "JAR-Template/trajectory.h"
 #include "JAR-Template/odom.h"
+#include "JAR-Template/motion_params.h"
 #include "JAR-Template/drive.h"
+#include "JAR-Template/chassis.h"
 #include "JAR-Template/util.h"
 #include "JAR-Template/PID.h"
 #include "autons.h"
+#include "1091A_ConfigStore.h"
+#include "1091A_Dashboard.h"
+#include "1091A_ControllerFeedback.h"
+#include "1091A_SelfTest.h"
+#include "1091A_TuningConsole.h"
+#include "1091A_AutonRegistry.h"
+#include "1091A_DriverInput.h"
 #include "1091A_DriverFunctions.h"
+#include "1091A_DriverAssist.h"
+#include "1091A_AutonScript.h"
+#include "1091A_AutonExecutor.h"
+#include "1091A_Benchmark.h"
 
 #define waitUntil(condition)                                                   \
   do {                                                                         \
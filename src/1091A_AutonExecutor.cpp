@@ -0,0 +1,106 @@
+#include "vex.h"
+#include "globals.h"
+#include "1091A_AutonExecutor.h"
+
+//How fast the learned step times follow new runs (0 = never change, 1 = only keep the last run)
+const float stepTimeLearningRate = 0.3;
+
+/// @brief Load learned step times.  Keeps the first guesses if there is no file or it is for a different step count
+static void loadStepTimes(const char* timingFile, const AutonStep steps[], int stepCount, float stepSeconds[]) {
+  for (int ii = 0; ii < stepCount; ii++) stepSeconds[ii] = steps[ii].expectedSeconds;
+  if (!Brain.SDcard.isInserted()) return;
+
+  float saved[AUTON_EXECUTOR_MAX_STEPS];
+  int32_t bytesRead = Brain.SDcard.loadfile(timingFile, reinterpret_cast<uint8_t*>(saved), sizeof(saved));
+  if (bytesRead != static_cast<int32_t>(stepCount*sizeof(float))) return;
+  for (int ii = 0; ii < stepCount; ii++) {
+    if (saved[ii] > 0 && saved[ii] < 15.0) stepSeconds[ii] = saved[ii];
+  }
+}
+
+static void saveStepTimes(const char* timingFile, int stepCount, float stepSeconds[]) {
+  if (!Brain.SDcard.isInserted()) return;
+  Brain.SDcard.savefile(timingFile, reinterpret_cast<uint8_t*>(stepSeconds), stepCount*sizeof(float));
+}
+
+/// @brief Pick the remaining optional steps worth the most points that fit in the time left
+/// @param firstStep first step not run yet
+/// @param secondsLeft time left in the budget
+/// @return bit mask over step indexes of the optional steps to run (required steps are not in the mask)
+static uint32_t pickOptionalSteps(const AutonStep steps[], int stepCount, const float stepSeconds[],
+                                  const bool stepRan[], int firstStep, float secondsLeft) {
+  float requiredSeconds = 0;
+  int optionalSteps[AUTON_EXECUTOR_MAX_STEPS];
+  int optionalCount = 0;
+  for (int ii = firstStep; ii < stepCount; ii++) {
+    if (steps[ii].points == 0) requiredSeconds += stepSeconds[ii];
+    else optionalSteps[optionalCount++] = ii;
+  }
+
+  //There are only a handful of optional steps, so just try every combination
+  uint32_t bestMask = 0;
+  int bestPoints = 0;
+  float bestSeconds = 0;
+  for (uint32_t combo = 1; combo < (1u << optionalCount); combo++) {
+    uint32_t mask = 0;
+    int points = 0;
+    float seconds = requiredSeconds;
+    for (int jj = 0; jj < optionalCount; jj++) {
+      if (combo & (1u << jj)) {
+        mask |= 1u << optionalSteps[jj];
+        points += steps[optionalSteps[jj]].points;
+        seconds += stepSeconds[optionalSteps[jj]];
+      }
+    }
+    if (seconds > secondsLeft) continue;
+
+    bool chainOk = true;
+    for (int jj = 0; jj < optionalCount && chainOk; jj++) {
+      int step = optionalSteps[jj];
+      if (!(mask & (1u << step)) || !steps[step].needsPreviousStep || step == 0) continue;
+      int previous = step - 1;
+      if (previous < firstStep) chainOk = stepRan[previous];
+      else chainOk = steps[previous].points == 0 || (mask & (1u << previous));
+    }
+    if (!chainOk) continue;
+
+    if (points > bestPoints || (points == bestPoints && seconds < bestSeconds)) {
+      bestMask = mask;
+      bestPoints = points;
+      bestSeconds = seconds;
+    }
+  }
+  return bestMask;
+}
+
+void runAutonSteps(const char* timingFile, const AutonStep steps[], int stepCount, int runCount, double budgetSeconds) {
+  if (stepCount > AUTON_EXECUTOR_MAX_STEPS) stepCount = AUTON_EXECUTOR_MAX_STEPS;
+  if (runCount > stepCount) runCount = stepCount;
+
+  float stepSeconds[AUTON_EXECUTOR_MAX_STEPS];
+  bool stepRan[AUTON_EXECUTOR_MAX_STEPS] = {};
+  loadStepTimes(timingFile, steps, stepCount, stepSeconds);
+
+  for (int ii = 0; ii < runCount; ii++) {
+    double stepStart = Brain.Timer.value();
+    if (steps[ii].points > 0) {
+      float secondsLeft = budgetSeconds - (stepStart - autonStartTime);
+      uint32_t plan = pickOptionalSteps(steps, runCount, stepSeconds, stepRan, ii, secondsLeft);
+      if (!(plan & (1u << ii))) continue;
+    }
+
+    steps[ii].action();
+    stepRan[ii] = true;
+
+    float tookSeconds = Brain.Timer.value() - stepStart;
+    stepSeconds[ii] += stepTimeLearningRate*(tookSeconds - stepSeconds[ii]);
+  }
+
+  //Steps left off this time keep the times they had, so the file always has the whole routine
+  saveStepTimes(timingFile, stepCount, stepSeconds);
+}
+
+void waitForAutonEnd(double budgetSeconds) {
+  double secondsLeft = budgetSeconds - (Brain.Timer.value() - autonStartTime);
+  if (secondsLeft > 0) task::sleep(static_cast<uint32_t>(secondsLeft*1000.0));
+}
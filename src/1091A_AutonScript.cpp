@@ -0,0 +1,242 @@
+#include "vex.h"
+#include "globals.h"
+#include "1091A_AutonScript.h"
+
+/* ******************************************************************************* */
+/* SD card auton scripts                                                           */
+/* The file is read and parsed once in pre_auton into autonScript. When the auton  */
+/* runs, the interpreter just walks the command array and calls the same drive,    */
+/* turn and mechanism functions the hand-written autos use.                        */
+/* ******************************************************************************* */
+
+AutonScript autonScript;
+
+static char autonScriptText[AUTON_SCRIPT_MAX_FILE_BYTES + 1];
+
+/// @brief Keyword table: script word, op it maps to, and how many numbers it takes
+struct AutonKeyword {
+  const char* name;
+  AutonOp op;
+  uint8_t minArgs;
+  uint8_t maxArgs;
+};
+
+static const AutonKeyword autonKeywords[] = {
+  {"setup", OP_SETUP, 0, 2},
+  {"reject", OP_REJECT, 1, 1},
+  {"drive", OP_DRIVE, 1, 2},
+  {"drive_small", OP_DRIVE_SMALL, 1, 1},
+  {"drive_medium", OP_DRIVE_MEDIUM, 1, 1},
+  {"drive_large", OP_DRIVE_LARGE, 1, 1},
+  {"max_voltage", OP_DRIVE_MAX_VOLTAGE, 1, 1},
+  {"drive_timeout", OP_DRIVE_TIMEOUT, 1, 1},
+  {"turn_tiny", OP_TURN_TINY, 1, 2},
+  {"turn_small", OP_TURN_SMALL, 1, 2},
+  {"turn_medium", OP_TURN_MEDIUM, 1, 2},
+  {"turn_large", OP_TURN_LARGE, 1, 2},
+  {"turn_xlarge", OP_TURN_XLARGE, 1, 2},
+  {"adjust", OP_ADJUST_HEADING, 3, 3},
+  {"swing", OP_SWING, 2, 3},
+  {"swing_back", OP_SWING_BACK, 2, 3},
+  {"voltage", OP_VOLTAGE, 2, 2},
+  {"stop", OP_STOP, 0, 1},
+  {"sleep", OP_SLEEP, 1, 1},
+  {"back_until_mm", OP_BACK_UNTIL_MM, 1, 2},
+  {"wait_for_end", OP_WAIT_FOR_END, 0, 0},
+  {"grab_mogo", OP_GRAB_MOGO, 0, 0},
+  {"clamp", OP_CLAMP, 0, 0},
+  {"release", OP_RELEASE, 0, 0},
+  {"doinker_down", OP_DOINKER_DOWN, 0, 0},
+  {"doinker_up", OP_DOINKER_UP, 0, 0},
+  {"intake", OP_INTAKE_FORWARD, 0, 0},
+  {"outtake", OP_INTAKE_REVERSE, 0, 0},
+  {"intake_stop", OP_INTAKE_STOP, 0, 0},
+  {"shoot_alliance", OP_SHOOT_ALLIANCE, 0, 0},
+  {"arm_receive", OP_ARM_RECEIVE, 0, 0},
+  {"arm_ladder", OP_ARM_LADDER, 0, 0},
+  {"arm_down", OP_ARM_DOWN, 0, 0},
+};
+
+/// @brief Words that can be used in place of numbers (ring colors and brake modes)
+struct AutonNamedValue {
+  const char* name;
+  float value;
+};
+
+static const AutonNamedValue autonNamedValues[] = {
+  {"blue", 0}, {"red", 1},
+  {"coast", 0}, {"brake", 1}, {"hold", 2},
+};
+
+/// @brief Read one number (or named value) from the token
+/// @return false if the token is not a number or a known name
+static bool parseAutonArg(const char* token, float& value) {
+  char* end;
+  value = strtof(token, &end);
+  if (end != token && *end == '\0') return true;
+
+  for (unsigned int ii = 0; ii < sizeof(autonNamedValues)/sizeof(autonNamedValues[0]); ii++) {
+    if (strcmp(token, autonNamedValues[ii].name) == 0) {
+      value = autonNamedValues[ii].value;
+      return true;
+    }
+  }
+  return false;
+}
+
+/// @brief Split the next whitespace separated token off the line (in place)
+static char* nextToken(char*& cursor) {
+  while (*cursor == ' ' || *cursor == '\t') cursor++;
+  if (*cursor == '\0') return NULL;
+  char* token = cursor;
+  while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t') cursor++;
+  if (*cursor != '\0') *cursor++ = '\0';
+  return token;
+}
+
+/// @brief Parse script text into the command array.  The text is modified in place
+/// @param text script text (one command per line, '#' starts a comment)
+/// @param length number of characters in text
+/// @param script where the parsed commands go
+/// @return true if every line parsed and the script fits
+bool parseAutonScript(char* text, int length, AutonScript& script) {
+  script.commandCount = 0;
+  script.loaded = false;
+  script.rejectRedRings = false;
+  script.errorLine = 0;
+
+  int lineNumber = 0;
+  char* lineStart = text;
+  char* textEnd = text + length;
+  while (lineStart < textEnd) {
+    lineNumber++;
+    char* lineEnd = lineStart;
+    while (lineEnd < textEnd && *lineEnd != '\n') lineEnd++;
+    *lineEnd = '\0';
+
+    //Drop comments and the '\r' of Windows line endings
+    for (char* c = lineStart; c < lineEnd; c++) {
+      if (*c == '#' || *c == '\r') { *c = '\0'; break; }
+    }
+
+    char* cursor = lineStart;
+    char* keyword = nextToken(cursor);
+    lineStart = lineEnd + 1;
+    if (keyword == NULL) continue;  //Blank line
+
+    const AutonKeyword* match = NULL;
+    for (unsigned int ii = 0; ii < sizeof(autonKeywords)/sizeof(autonKeywords[0]); ii++) {
+      if (strcmp(keyword, autonKeywords[ii].name) == 0) {
+        match = &autonKeywords[ii];
+        break;
+      }
+    }
+    if (match == NULL || script.commandCount >= AUTON_SCRIPT_MAX_COMMANDS) {
+      script.errorLine = lineNumber;
+      return false;
+    }
+
+    AutonCommand& command = script.commands[script.commandCount];
+    command.op = match->op;
+    command.line = lineNumber;
+    command.argCount = 0;
+    char* token;
+    while ((token = nextToken(cursor)) != NULL) {
+      if (command.argCount >= match->maxArgs || !parseAutonArg(token, command.args[command.argCount])) {
+        script.errorLine = lineNumber;
+        return false;
+      }
+      command.argCount++;
+    }
+    if (command.argCount < match->minArgs) {
+      script.errorLine = lineNumber;
+      return false;
+    }
+
+    //The ring color to reject is needed before the auton starts (for the sorting task), so keep it out of the command list
+    if (command.op == OP_REJECT) script.rejectRedRings = command.args[0] > 0.5;
+    else script.commandCount++;
+  }
+
+  script.loaded = true;
+  return true;
+}
+
+/// @brief Load and parse an auton script from the SD card.  Called once from pre_auton
+/// @param fileName file on the SD card
+/// @return true if the script loaded and parsed
+bool loadAutonScript(const char* fileName) {
+  autonScript.loaded = false;
+  if (!Brain.SDcard.isInserted()) return false;
+
+  int32_t length = Brain.SDcard.loadfile(fileName, reinterpret_cast<uint8_t*>(autonScriptText), AUTON_SCRIPT_MAX_FILE_BYTES);
+  if (length <= 0) return false;
+  autonScriptText[length] = '\0';
+
+  return parseAutonScript(autonScriptText, length, autonScript);
+}
+
+/// @brief Run the loaded script, one command after another
+void runAutonScript() {
+  for (int ii = 0; ii < autonScript.commandCount; ii++) {
+    const AutonCommand& command = autonScript.commands[ii];
+    const float* args = command.args;
+
+    switch (command.op) {
+      case OP_SETUP:
+        if (command.argCount == 2) setup_auto(args[0], args[1], true);
+        else setup_auto();
+        break;
+      case OP_REJECT:
+        break;
+      case OP_DRIVE:
+        if (command.argCount == 2) chassis.drive_max_voltage = args[1];
+        chassis.drive_distance(args[0]);
+        break;
+      case OP_DRIVE_SMALL: drive_distance_small(args[0]); break;
+      case OP_DRIVE_MEDIUM: drive_distance_medium(args[0]); break;
+      case OP_DRIVE_LARGE: drive_distance_large(args[0]); break;
+      case OP_DRIVE_MAX_VOLTAGE: chassis.drive_max_voltage = args[0]; break;
+      case OP_DRIVE_TIMEOUT: chassis.drive_timeout = args[0]; break;
+      case OP_TURN_TINY: turn_to_heading_tiny(args[0], (command.argCount == 2) ? args[1] : 1.0); break;
+      case OP_TURN_SMALL: turn_to_heading_small(args[0], (command.argCount == 2) ? args[1] : 1.0); break;
+      case OP_TURN_MEDIUM: turn_to_heading_medium(args[0], (command.argCount == 2) ? args[1] : 1.0); break;
+      case OP_TURN_LARGE: turn_to_heading_large(args[0], (command.argCount == 2) ? args[1] : 1.0); break;
+      case OP_TURN_XLARGE: turn_to_heading_xlarge(args[0], (command.argCount == 2) ? args[1] : 1.0); break;
+      case OP_ADJUST_HEADING: adjustHeading(args[0], args[1], args[2]); break;
+      case OP_SWING:
+      case OP_SWING_BACK:
+        chassis.swing_arc_to_angle(args[0], args[1], command.op == OP_SWING_BACK, (command.argCount == 3) ? args[2] : 0);
+        break;
+      case OP_VOLTAGE: chassis.drive_with_voltage(args[0], args[1]); break;
+      case OP_STOP:
+        if (command.argCount == 0 || args[0] < 0.5) chassis.drive_stop(coast);
+        else if (args[0] < 1.5) chassis.drive_stop(brake);
+        else chassis.drive_stop(hold);
+        break;
+      case OP_SLEEP: task::sleep(static_cast<uint32_t>(args[0])); break;
+      case OP_BACK_UNTIL_MM: {
+        float volts = (command.argCount == 2) ? args[1] : 2.5;
+        chassis.stop_on_distance(backDistanceSensor, args[0]);
+        chassis.drive_until_contact(-volts, 3000);
+        chassis.drive_stop(hold);
+        break;
+      }
+      case OP_WAIT_FOR_END: waitForAutonEnd(15.0); break;
+      case OP_GRAB_MOGO: acquire_mogo(); break;
+      case OP_CLAMP: clampMogo(); break;
+      case OP_RELEASE: releaseMogo(); break;
+      case OP_DOINKER_DOWN: lowerDoinker(); break;
+      case OP_DOINKER_UP: raiseDoinker(); break;
+      case OP_INTAKE_FORWARD: intakeAndConveyor.spin(forward); break;
+      case OP_INTAKE_REVERSE: intakeAndConveyor.spin(reverse); break;
+      case OP_INTAKE_STOP: intakeAndConveyor.stop(brakeType::coast); break;
+      case OP_SHOOT_ALLIANCE: shoot_alliance_ring(); break;
+      case OP_ARM_RECEIVE: gotoReceiveRingPosition(); break;
+      case OP_ARM_LADDER: { vex::task armTask(spinArmUpForLadder, vex::task::taskPriorityNormal); break; }
+      case OP_ARM_DOWN: { vex::task armTask(spinArmBackDown, vex::task::taskPriorityNormal); break; }
+    }
+  }
+  intakeAndConveyor.stop(brakeType::coast);
+  chassis.drive_stop(coast);
+}
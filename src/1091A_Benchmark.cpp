@@ -0,0 +1,137 @@
+#include "vex.h"
+#include "1091A_Benchmark.h"
+
+/* ******************************************************************************* */
+/* Kernel timing. Only uses the hardware-free JAR-Template code (PID, odom, util,  */
+/* mpc), so it also builds on a PC against tools/host/vex.h.                       */
+/* ******************************************************************************* */
+
+#define BENCHMARK_SAMPLES 500  //5 seconds of driving at 100Hz
+#define BENCHMARK_PASSES 40
+
+//Synthetic drive: forward tracker, sideways tracker, heading, and the errors and outputs a motion would see
+static float forwardTrackerSamples[BENCHMARK_SAMPLES];
+static float sidewaysTrackerSamples[BENCHMARK_SAMPLES];
+static float headingSamples[BENCHMARK_SAMPLES];
+static float errorSamples[BENCHMARK_SAMPLES];
+static float driveOutputSamples[BENCHMARK_SAMPLES];
+static float headingOutputSamples[BENCHMARK_SAMPLES];
+
+volatile float benchmarkSink;  //Results go here so the compiler cannot drop the timed work
+
+/// @brief An S-curve: accelerate, sweep left then right, and settle on a target, like a drive_to_pose
+static void makeBenchmarkSamples() {
+  float forward = 0, heading = 0;
+  for (int ii = 0; ii < BENCHMARK_SAMPLES; ii++) {
+    float t = ii/float(BENCHMARK_SAMPLES);
+    float speed = 0.6*sin(M_PI*t);  //inches per tick
+    forward += speed;
+    heading = reduce_0_to_360(heading + 1.5*sin(2*M_PI*t));
+    forwardTrackerSamples[ii] = forward;
+    sidewaysTrackerSamples[ii] = 0.02*sin(6*M_PI*t);  //A little scrub
+    headingSamples[ii] = heading;
+    errorSamples[ii] = 48*(1 - t) + 2*sin(20*M_PI*t);
+    driveOutputSamples[ii] = 14*(1 - t);  //Starts above 12V so scaling has to kick in
+    headingOutputSamples[ii] = 6*sin(2*M_PI*t);
+  }
+}
+
+/// @brief Time calls of kernel(sample index) over every sample, passes times
+template <typename Kernel>
+static KernelBenchmark timeKernel(const char* name, Kernel kernel, uint64_t (*microseconds)(), float clockMHz, int passes = BENCHMARK_PASSES) {
+  float total = 0;
+  uint64_t start = microseconds();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int ii = 0; ii < BENCHMARK_SAMPLES; ii++) total += kernel(ii);
+  }
+  uint64_t elapsed = microseconds() - start;
+  benchmarkSink = total;
+
+  KernelBenchmark result;
+  result.name = name;
+  result.nsPerCall = elapsed*1000.0/(passes*BENCHMARK_SAMPLES);
+  result.cyclesPerCall = result.nsPerCall*clockMHz/1000.0;
+  return result;
+}
+
+// Kernels, written as plain functions so they can go through the template above
+
+static PID benchmarkPID(0, 0.4, 0.03, 1.6, 5, 1.5, 300, 0);
+static Odom benchmarkOdom;
+
+static float pidKernel(int ii) {
+  return benchmarkPID.compute(errorSamples[ii]);
+}
+
+static float odomKernel(int ii) {
+  //Starting over at the top of each pass keeps the tracker deltas the same as the first pass
+  if (ii == 0) benchmarkOdom.set_position(0, 0, headingSamples[0], forwardTrackerSamples[0], sidewaysTrackerSamples[0]);
+  benchmarkOdom.update_position(forwardTrackerSamples[ii], sidewaysTrackerSamples[ii], headingSamples[ii]);
+  return benchmarkOdom.X_position;
+}
+
+static float voltageScalingKernel(int ii) {
+  return left_voltage_scaling(driveOutputSamples[ii], headingOutputSamples[ii]) +
+         right_voltage_scaling(driveOutputSamples[ii], headingOutputSamples[ii]);
+}
+
+static float lineSettledKernel(int ii) {
+  return is_line_settled(24, 48, headingSamples[ii], forwardTrackerSamples[ii]*0.3, forwardTrackerSamples[ii]);
+}
+
+static float reduceKernel(int ii) {
+  return reduce_negative_180_to_180(headingSamples[ii]*7 - 3000);
+}
+
+static float sincosKernel(int ii) {
+  float sin_out, cos_out;
+  fast_sincos_deg(headingSamples[ii], sin_out, cos_out);
+  return sin_out + cos_out;
+}
+
+/// @brief One tick of drive_to_pose math without the motor calls: carrot, errors, both PIDs and the output shaping
+static float carrotKernel(int ii) {
+  static PID drivePID(0, 1.5, 0, 10, 0, 1.5, 300, 0);
+  static PID headingPID(0, 0.4, 0, 1, 0);
+  const float target_X = 24, target_Y = 48, sin_angle = 0.7071, cos_angle = 0.7071, lead = 0.5, setback = 0;
+  float X = forwardTrackerSamples[ii]*0.3, Y = forwardTrackerSamples[ii], heading = headingSamples[ii];
+
+  float target_distance = hypot(target_X-X, target_Y-Y);
+  float carrot_X = target_X - sin_angle * (lead * target_distance + setback);
+  float carrot_Y = target_Y - cos_angle * (lead * target_distance + setback);
+  float drive_error = hypot(carrot_X-X, carrot_Y-Y);
+  float heading_error = reduce_negative_180_to_180(to_deg(atan2(carrot_X-X, carrot_Y-Y))-heading);
+
+  float drive_output = drivePID.compute(drive_error);
+  float heading_scale_factor = fast_cos(to_rad(heading_error));
+  drive_output *= heading_scale_factor;
+  heading_error = reduce_negative_90_to_90(heading_error);
+  float heading_output = headingPID.compute(heading_error);
+  drive_output = clamp(drive_output, -fabs(heading_scale_factor)*12, fabs(heading_scale_factor)*12);
+  heading_output = clamp(heading_output, -6, 6);
+  drive_output = clamp_min_voltage(drive_output, 0);
+  return left_voltage_scaling(drive_output, heading_output) + right_voltage_scaling(drive_output, heading_output);
+}
+
+/// @brief One MPC plan toward a pose from the sample position (the whole QP solve)
+static float mpcKernel(int ii) {
+  static MPC mpc;
+  if (mpc.track_width == 0) mpc.set_model(64.8, 150, 11.5);
+  mpc.compute(forwardTrackerSamples[ii]*0.3, forwardTrackerSamples[ii], headingSamples[ii], 24, 48, 45);
+  return mpc.left_speed;
+}
+
+void runKernelBenchmarks(uint64_t (*microseconds)(), float clockMHz, KernelBenchmark results[]) {
+  makeBenchmarkSamples();
+  benchmarkOdom.set_physical_distances(0.5, -1.5);
+
+  int count = 0;
+  results[count++] = timeKernel("PID::compute", pidKernel, microseconds, clockMHz);
+  results[count++] = timeKernel("Odom::update", odomKernel, microseconds, clockMHz);
+  results[count++] = timeKernel("voltage_scaling", voltageScalingKernel, microseconds, clockMHz);
+  results[count++] = timeKernel("is_line_settled", lineSettledKernel, microseconds, clockMHz);
+  results[count++] = timeKernel("reduce_180", reduceKernel, microseconds, clockMHz);
+  results[count++] = timeKernel("fast_sincos_deg", sincosKernel, microseconds, clockMHz);
+  results[count++] = timeKernel("pose_carrot_tick", carrotKernel, microseconds, clockMHz);
+  results[count++] = timeKernel("MPC::compute", mpcKernel, microseconds, clockMHz, 1);  //Thousands of times slower than the rest
+}
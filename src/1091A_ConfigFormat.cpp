@@ -0,0 +1,111 @@
+#include <stddef.h>
+#include <string.h>
+#include "1091A_ConfigStore.h"
+
+// Only the C library and 1091A_ConfigStore.h, so tools can build this file for a PC.
+
+#define CONFIG_FLOATS(member) static_cast<int>(offsetof(RobotConfig, member)/sizeof(float))
+
+constexpr int turnFloats = sizeof(turn_params)/sizeof(float);
+constexpr int driveFloats = sizeof(drive_params)/sizeof(float);
+
+extern constexpr RobotConfigSection robotConfigSections[] = {
+  {"turn", CONFIG_FLOATS(turn), turnFloats},
+  {"drive", CONFIG_FLOATS(drive), driveFloats},
+  {"swing", CONFIG_FLOATS(swing), turnFloats},
+  {"heading_rate", CONFIG_FLOATS(headingRatePerVolt), 2},
+  {"swing_profile", CONFIG_FLOATS(swingMaxRate), 2},
+  {"turn_tiny", CONFIG_FLOATS(turnPresets[TURN_PRESET_TINY]), turnFloats},
+  {"turn_small", CONFIG_FLOATS(turnPresets[TURN_PRESET_SMALL]), turnFloats},
+  {"turn_medium", CONFIG_FLOATS(turnPresets[TURN_PRESET_MEDIUM]), turnFloats},
+  {"turn_large", CONFIG_FLOATS(turnPresets[TURN_PRESET_LARGE]), turnFloats},
+  {"turn_xlarge", CONFIG_FLOATS(turnPresets[TURN_PRESET_XLARGE]), turnFloats},
+  {"adjust", CONFIG_FLOATS(turnPresets[TURN_PRESET_ADJUST_HEADING]), turnFloats},
+  {"drive_small", CONFIG_FLOATS(drivePresets[DRIVE_PRESET_SMALL]), driveFloats},
+  {"drive_medium", CONFIG_FLOATS(drivePresets[DRIVE_PRESET_MEDIUM]), driveFloats},
+  {"drive_large", CONFIG_FLOATS(drivePresets[DRIVE_PRESET_LARGE]), driveFloats},
+  {"sensor_offsets", CONFIG_FLOATS(frontSensorForwardOffset), 3},
+  {"mogo_approach", CONFIG_FLOATS(mogoApproachVoltage), 5},
+  {"wp_start", CONFIG_FLOATS(allianceStakeBackedUpX), 2},
+};
+
+constexpr int sectionCount = sizeof(robotConfigSections)/sizeof(robotConfigSections[0]);
+const int robotConfigSectionCount = sectionCount;
+
+/// @brief Checked at compile time: the sections cover RobotConfig in order with no gaps, so every field has a name
+constexpr bool sectionsCover(int index, int offset) {
+  return index == sectionCount ? offset == static_cast<int>(sizeof(RobotConfig)/sizeof(float)) :
+    robotConfigSections[index].offset == offset && sectionsCover(index + 1, offset + robotConfigSections[index].count);
+}
+
+static_assert(sectionsCover(0, 0), "robotConfigSections must cover every RobotConfig field in order");
+
+/// @brief CRC-32 (the zip/PNG one), four bits at a time from a 16 entry table
+/// @param data bytes to check
+/// @param length number of bytes
+/// @return checksum
+uint32_t robotConfigChecksum(const uint8_t* data, int length) {
+  static const uint32_t nibbleTable[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+  };
+  uint32_t crc = 0xFFFFFFFF;
+  for (int ii = 0; ii < length; ii++) {
+    crc ^= data[ii];
+    crc = (crc >> 4) ^ nibbleTable[crc & 0x0F];
+    crc = (crc >> 4) ^ nibbleTable[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+/// @brief Same checks as the compile-time ones on the presets, for values that came from a file
+bool robotConfigValid(const RobotConfig& config) {
+  if (!valid_turn_params(config.turn) || !valid_drive_params(config.drive) || !valid_turn_params(config.swing)) return false;
+  for (int ii = 0; ii < TURN_PRESET_COUNT; ii++) {
+    if (!valid_turn_params(config.turnPresets[ii])) return false;
+  }
+  for (int ii = 0; ii < DRIVE_PRESET_COUNT; ii++) {
+    if (!valid_drive_params(config.drivePresets[ii])) return false;
+  }
+  return config.swingMaxRate > 0 && config.swingMaxAccel > 0 && config.relocalizeGain >= 0 && config.relocalizeGain <= 1 &&
+    valid_voltage(config.mogoApproachVoltage) && config.mogoBrakingDecel > 0 && config.mogoApproachTimeout > 0 &&
+    config.mogoMaxTravel > 0;
+}
+
+/// @brief Write the file contents: header, then the config bytes
+/// @param config values to write
+/// @param out buffer for the file
+/// @param maxBytes size of out
+/// @return number of bytes written, or 0 if out is too small
+int encodeRobotConfig(const RobotConfig& config, uint8_t* out, int maxBytes) {
+  if (maxBytes < robotConfigFileBytes) return 0;
+  RobotConfigHeader header;
+  header.magic = ROBOT_CONFIG_MAGIC;
+  header.version = ROBOT_CONFIG_VERSION;
+  header.payloadBytes = sizeof(RobotConfig);
+  header.checksum = robotConfigChecksum(reinterpret_cast<const uint8_t*>(&config), sizeof(RobotConfig));
+  memcpy(out, &header, sizeof(header));
+  memcpy(out + sizeof(header), &config, sizeof(RobotConfig));
+  return robotConfigFileBytes;
+}
+
+/// @brief Check the file contents and copy them into config.  config is only changed if everything checks out
+/// @param data file contents
+/// @param length number of bytes in data
+/// @param config where the values go
+/// @return CONFIG_LOADED, or why the file was not used
+RobotConfigStatus decodeRobotConfig(const uint8_t* data, int length, RobotConfig& config) {
+  RobotConfigHeader header;
+  if (length != robotConfigFileBytes) return CONFIG_BAD_HEADER;
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != ROBOT_CONFIG_MAGIC || header.version != ROBOT_CONFIG_VERSION || header.payloadBytes != sizeof(RobotConfig)) {
+    return CONFIG_BAD_HEADER;
+  }
+  if (robotConfigChecksum(data + sizeof(header), sizeof(RobotConfig)) != header.checksum) return CONFIG_BAD_CHECKSUM;
+
+  RobotConfig loaded;
+  memcpy(&loaded, data + sizeof(header), sizeof(RobotConfig));
+  if (!robotConfigValid(loaded)) return CONFIG_BAD_VALUES;
+  config = loaded;
+  return CONFIG_LOADED;
+}
@@ -0,0 +1,54 @@
+#include "vex.h"
+
+/* ******************************************************************************* */
+/* Robot side of the SD card config (the file format is in 1091A_ConfigFormat.cpp). */
+/* loadRobotConfig() runs in pre_auton before default_constants(), which reads the */
+/* drive defaults from robotConfig.                                                */
+/* ******************************************************************************* */
+
+RobotConfig robotConfig = robotConfigDefaults;
+RobotConfigStatus robotConfigStatus = CONFIG_DEFAULTS;
+uint32_t robotConfigDecodeMicros = 0;
+
+static uint8_t robotConfigFile[robotConfigFileBytes];
+
+/// @brief Load the config file into robotConfig.  Anything wrong with the file leaves the compiled-in values
+/// @param fileName file on the SD card
+/// @return CONFIG_LOADED, or why the compiled-in values are in use
+RobotConfigStatus loadRobotConfig(const char* fileName) {
+  robotConfig = robotConfigDefaults;
+  robotConfigStatus = CONFIG_DEFAULTS;
+  if (!Brain.SDcard.isInserted() || !Brain.SDcard.exists(fileName)) return robotConfigStatus;
+
+  //Read one byte more than a good file has, so a longer file is caught as the wrong size
+  static uint8_t readBuffer[robotConfigFileBytes + 1];
+  int32_t length = Brain.SDcard.loadfile(fileName, readBuffer, sizeof(readBuffer));
+  if (length <= 0) return robotConfigStatus;
+
+  uint64_t startMicros = timer::systemHighResolution();
+  robotConfigStatus = decodeRobotConfig(readBuffer, length, robotConfig);
+  robotConfigDecodeMicros = static_cast<uint32_t>(timer::systemHighResolution() - startMicros);
+  if (robotConfigStatus != CONFIG_LOADED) printf("config: %s not used (%s)\n", fileName, robotConfigStatusText());
+  return robotConfigStatus;
+}
+
+/// @brief Write robotConfig to the SD card
+/// @param fileName file on the SD card
+/// @return true if the whole file was written
+bool saveRobotConfig(const char* fileName) {
+  if (!Brain.SDcard.isInserted()) return false;
+  int length = encodeRobotConfig(robotConfig, robotConfigFile, sizeof(robotConfigFile));
+  return length > 0 && Brain.SDcard.savefile(fileName, robotConfigFile, length) == length;
+}
+
+/// @brief Short description of robotConfigStatus for the Brain screen
+const char* robotConfigStatusText() {
+  switch (robotConfigStatus) {
+    case CONFIG_DEFAULTS: return "built-in";
+    case CONFIG_LOADED: return "SD card";
+    case CONFIG_BAD_HEADER: return "bad version";
+    case CONFIG_BAD_CHECKSUM: return "bad checksum";
+    case CONFIG_BAD_VALUES: return "bad values";
+  }
+  return "";
+}
@@ -0,0 +1,84 @@
+#include "vex.h"
+#include <stdarg.h>
+
+/*---------------------------------------------------------------------------*/
+/*  Controller feedback                                                      */
+/*  A line is sent padded with spaces to the full width, so it overwrites    */
+/*  the old text in one message instead of a clear and a print.             */
+/*---------------------------------------------------------------------------*/
+
+ControllerFeedback controllerFeedback;
+
+/// @brief Change what a controller screen line says.  It is sent later by controllerFeedbackTask, if it changed
+/// @param row 0 to 2, top to bottom
+/// @param format printf format and arguments
+void ControllerFeedback::setLine(int row, const char* format, ...) {
+  if (row < 0 || row >= controllerLineCount) return;
+  char text[CONTROLLER_LINE_LENGTH + 1];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  if (strcmp(text, wanted[row]) == 0) return;
+  strcpy(wanted[row], text);
+  lineDirty[row] = strcmp(wanted[row], shown[row]) != 0;  //Changed and changed back before it was sent: nothing to send
+}
+
+/// @brief Blank every line
+void ControllerFeedback::clear() {
+  for (int row = 0; row < controllerLineCount; row++) setLine(row, "");
+}
+
+/// @brief Queue a rumble.  Ignored if the same pattern is already waiting or the queue is full
+/// @param pattern string literal of '.', '-' and ' ' (like RUMBLE_CONFIRM)
+void ControllerFeedback::rumble(const char* pattern) {
+  for (int ii = 0; ii < rumbleCount; ii++) {
+    if (strcmp(rumbleQueue[ii], pattern) == 0) return;
+  }
+  if (rumbleCount < controllerRumbleQueueLength) rumbleQueue[rumbleCount++] = pattern;
+}
+
+/// @brief Send every line again (the controller screen was cleared, or the controller reconnected)
+void ControllerFeedback::resend() {
+  for (int row = 0; row < controllerLineCount; row++) lineDirty[row] = true;
+}
+
+/// @brief Send one message: the oldest queued rumble, otherwise the next changed line
+/// @return true if a message was sent (and the link needs controllerMessageMSec before the next one)
+bool ControllerFeedback::sendNext() {
+  if (rumbleCount > 0) {
+    Controller1.rumble(rumbleQueue[0]);
+    rumbleCount--;
+    for (int ii = 0; ii < rumbleCount; ii++) rumbleQueue[ii] = rumbleQueue[ii + 1];
+    return true;
+  }
+
+  for (int checked = 0; checked < controllerLineCount; checked++) {
+    int row = (nextLine + checked) % controllerLineCount;
+    if (!lineDirty[row]) continue;
+    char padded[CONTROLLER_LINE_LENGTH + 1];
+    snprintf(padded, sizeof(padded), "%-*s", CONTROLLER_LINE_LENGTH, wanted[row]);
+    Controller1.Screen.setCursor(row + 1, 1);
+    Controller1.Screen.print("%s", padded);
+    strcpy(shown[row], wanted[row]);
+    lineDirty[row] = false;
+    nextLine = (row + 1) % controllerLineCount;
+    return true;
+  }
+  return false;
+}
+
+/// @brief Sends the controller feedback, one message per link slot.  Started in pre_auton
+int controllerFeedbackTask() {
+  bool connected = false;
+  while (true) {
+    //Whatever the controller showed is gone after it reconnects
+    bool nowConnected = Controller1.installed();
+    if (nowConnected && !connected) controllerFeedback.resend();
+    connected = nowConnected;
+
+    if (connected && controllerFeedback.sendNext()) task::sleep(controllerMessageMSec);
+    else task::sleep(10);
+  }
+  return 0;
+}
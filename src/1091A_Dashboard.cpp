@@ -0,0 +1,163 @@
+#include "vex.h"
+#include <stdarg.h>
+
+/*---------------------------------------------------------------------------*/
+/*  Brain screen dashboard                                                   */
+/*  Text lines are padded with spaces out to the length of what they         */
+/*  replace, so drawing a line over itself is all it takes to change it. The */
+/*  robot marker is moved by blanking the box it was in and putting back the */
+/*  tile lines that crossed that box, not by redrawing the whole map.        */
+/*---------------------------------------------------------------------------*/
+
+Dashboard dashboard;
+
+static const int robotRadius = 5;
+static const int headingLength = 10;  //Heading line, from the center of the marker
+static const int robotBox = headingLength + 2;  //Half the size of the box the marker can cover
+static const float pixelsPerInch = dashboardMapSize/dashboardFieldInches;
+static const color mapGridColor = color(60, 60, 60);
+
+/// @brief Change a line of text.  Nothing is drawn until draw(), and only if the text changed
+/// @param id which line
+/// @param format printf format and arguments
+void Dashboard::setText(DashboardText id, const char* format, ...) {
+  char text[DASHBOARD_TEXT_LENGTH + 1];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  TextWidget& widget = texts[id];
+  if (strcmp(text, widget.wanted) == 0) return;
+  strcpy(widget.wanted, text);
+  widget.dirty = true;
+}
+
+/// @brief Change the background color of a line of text
+void Dashboard::setTextColor(DashboardText id, const color& fill) {
+  TextWidget& widget = texts[id];
+  if (widget.fill == fill.rgb()) return;
+  widget.fill = fill.rgb();
+  widget.dirty = true;
+}
+
+/// @brief Move the robot on the field map.  The marker is only redrawn when it would land on different pixels
+/// @param X_position field X in inches
+/// @param Y_position field Y in inches
+/// @param absolute_heading degrees, 0 is +Y and clockwise is positive
+void Dashboard::setPose(float X_position, float Y_position, float absolute_heading) {
+  const int centerX = dashboardMapLeft + dashboardMapSize/2;
+  const int centerY = dashboardMapTop + dashboardMapSize/2;
+  const int limit = dashboardMapSize/2 - robotBox;  //Keep the marker inside the map, even when odom is off the field
+  int x = centerX + static_cast<int>(clamp(X_position*pixelsPerInch, -limit, limit));
+  int y = centerY - static_cast<int>(clamp(Y_position*pixelsPerInch, -limit, limit));
+  float sin_heading, cos_heading;
+  fast_sincos_deg(absolute_heading, sin_heading, cos_heading);
+  int tipX = x + static_cast<int>(roundf(headingLength*sin_heading));
+  int tipY = y - static_cast<int>(roundf(headingLength*cos_heading));
+
+  if (robotShown && x == shownX && y == shownY && tipX == shownTipX && tipY == shownTipY) {
+    robotDirty = false;
+    return;
+  }
+  wantedX = x;
+  wantedY = y;
+  wantedTipX = tipX;
+  wantedTipY = tipY;
+  robotDirty = true;
+}
+
+/// @brief Clear the screen and draw everything again on the next frame (after something else drew over it)
+void Dashboard::invalidate() {
+  clearPending = true;
+}
+
+/// @brief Draw what changed since the last frame, taking the lines in turn, until the time budget is used
+/// @param budgetMicros time after which no more widgets are started (at least one always is)
+void Dashboard::draw(uint32_t budgetMicros) {
+  if (paused) return;
+  uint64_t startMicros = timer::systemHighResolution();
+  bool drewSomething = false;
+
+  if (clearPending) {
+    Brain.Screen.clearScreen();
+    for (int ii = 0; ii < DASH_TEXT_COUNT; ii++) {
+      texts[ii].shown[0] = '\0';
+      texts[ii].dirty = texts[ii].wanted[0] != '\0';
+    }
+    drawMapGrid(dashboardMapLeft, dashboardMapTop, dashboardMapLeft + dashboardMapSize, dashboardMapTop + dashboardMapSize);
+    robotShown = false;
+    robotDirty = true;
+    clearPending = false;
+    drewSomething = true;
+  }
+
+  //The robot first: it is the one thing on the screen that changes every frame while driving
+  if (robotDirty) {
+    drawRobot();
+    drewSomething = true;
+  }
+
+  int checked = 0;
+  for (; checked < DASH_TEXT_COUNT; checked++) {
+    int id = (nextText + checked) % DASH_TEXT_COUNT;
+    if (!texts[id].dirty) continue;
+    if (drewSomething && timer::systemHighResolution() - startMicros > budgetMicros) break;
+    drawText(id);
+    drewSomething = true;
+  }
+  nextText = (nextText + checked) % DASH_TEXT_COUNT;
+
+  uint32_t frameMicros = static_cast<uint32_t>(timer::systemHighResolution() - startMicros);
+  averageFrameMicros = averageFrameMicros - averageFrameMicros/8 + frameMicros/8;
+}
+
+/// @brief Draw a line of text over the last one, with spaces to cover any longer text it replaces
+void Dashboard::drawText(int id) {
+  TextWidget& widget = texts[id];
+  const DashboardTextLayout& layout = dashboardTextLayout[id];
+  char padded[DASHBOARD_TEXT_LENGTH + 1];
+  snprintf(padded, sizeof(padded), "%-*s", static_cast<int>(strlen(widget.shown)), widget.wanted);
+  Brain.Screen.setFont(layout.font);
+  Brain.Screen.setPenColor(color::white);
+  Brain.Screen.setFillColor(color(widget.fill));
+  Brain.Screen.printAt(layout.x, layout.y, padded);
+  strcpy(widget.shown, widget.wanted);
+  widget.dirty = false;
+}
+
+/// @brief Draw the parts of the tile lines that fall inside a box on the map
+/// @param left, top, right, bottom the box in screen pixels
+void Dashboard::drawMapGrid(int left, int top, int right, int bottom) {
+  Brain.Screen.setPenWidth(1);
+  Brain.Screen.setPenColor(mapGridColor);
+  for (int ii = 0; ii <= dashboardMapTiles; ii++) {
+    int line = ii*dashboardMapSize/dashboardMapTiles;
+    int x = dashboardMapLeft + line;
+    int y = dashboardMapTop + line;
+    if (x >= left && x <= right) Brain.Screen.drawLine(x, top, x, bottom);
+    if (y >= top && y <= bottom) Brain.Screen.drawLine(left, y, right, y);
+  }
+}
+
+/// @brief Erase the marker where it was and draw it where it is now
+void Dashboard::drawRobot() {
+  if (robotShown) {
+    Brain.Screen.setPenColor(color::black);
+    Brain.Screen.setFillColor(color::black);
+    Brain.Screen.drawRectangle(shownX - robotBox, shownY - robotBox, 2*robotBox + 1, 2*robotBox + 1);
+    drawMapGrid(shownX - robotBox, shownY - robotBox, shownX + robotBox, shownY + robotBox);
+  }
+  Brain.Screen.setPenColor(color::yellow);
+  Brain.Screen.setFillColor(color::yellow);
+  Brain.Screen.drawCircle(wantedX, wantedY, robotRadius);
+  Brain.Screen.setPenWidth(2);
+  Brain.Screen.drawLine(wantedX, wantedY, wantedTipX, wantedTipY);
+  Brain.Screen.setPenWidth(1);
+
+  shownX = wantedX;
+  shownY = wantedY;
+  shownTipX = wantedTipX;
+  shownTipY = wantedTipY;
+  robotShown = true;
+  robotDirty = false;
+}
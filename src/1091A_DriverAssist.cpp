@@ -0,0 +1,177 @@
+#include "vex.h"
+#include "globals.h"
+
+/*---------------------------------------------------------------------------*/
+/*  Driver assist modes                                                      */
+/*  These run inside the usercontrol() loop one tick at a time (the ladder   */
+/*  drive runs drive_to_pose() on its own task), so the mechanisms keep      */
+/*  working and the driver can take over at any moment.                      */
+/*---------------------------------------------------------------------------*/
+
+//Stick movement (in percent) that cancels an assist and gives the drive back to the driver
+const float assistOverrideThreshold = 20.0;
+
+//How long Y has to be held to start the ladder drive instead of a heading snap
+const double ladderHoldMSec = 400.0;
+
+//Snap to heading
+const float snapHeadingStep = 90.0;
+const double snapSettleMSec = 60.0;
+
+//Mogo align: back up with a P loop on the back distance sensor and clamp at contact
+const double mogoSearchDistanceMM = 700.0;  //Nothing closer than this means there is no mogo behind us
+const float mogoAlignKp = 0.03;  //volts per mm
+const float mogoAlignMinVoltage = 3.0;
+const float mogoAlignMaxVoltage = 9.0;
+
+//Ladder: field coordinates in inches with the ladder at the field center.
+//The ladder is a diamond, so its faces point at 45, 135, 225 and 315 degrees.
+const float ladderCenterX = 0.0;
+const float ladderCenterY = 0.0;
+const float ladderFirstFaceAngle = 45.0;
+const float ladderApproachDistance = 26.0;  //Tracking center distance from the ladder center when touching a face
+
+static float ladderTargetX = 0;
+static float ladderTargetY = 0;
+static float ladderTargetHeading = 0;
+static volatile bool ladderDriveDone = false;
+
+/// @brief Task body for the ladder drive.  drive_to_pose() blocks, so it runs here while usercontrol() keeps looping
+/// @return always returns zero since Vex::task class expects that
+static int driveToLadderTask() {
+  chassis.drive_to_pose(ladderTargetX, ladderTargetY, ladderTargetHeading, \
+      /* lead, setback, min volts */ 0.5, 0, 0, \
+      /* driving volts, heading volts */ 8, 10, \
+      /* tolerance, settle time, timeout */ 1.0, 100, 3000);
+  chassis.drive_stop(brake);
+  ladderDriveDone = true;
+  return 0;
+}
+
+/// @brief Check if the driver is moving a stick enough to take the drive back
+static bool isStickOverride(int axisValue) {
+  return fabs(static_cast<float>(axisValue)) > assistOverrideThreshold;
+}
+
+/// @brief Run one tick of the driver assists
+/// @param input this tick's controller snapshot
+/// @return true if an assist is driving the chassis this tick (so arcade control should be skipped)
+bool DriverAssist::update(const DriverInput& input) {
+  //Start a new assist from the buttons (a new request replaces whatever was running)
+  if (input.Y.holdStarted(ladderHoldMSec, input.tickMSec) && fieldPoseKnown) startDriveToLadder();
+  else if (input.Y.released && input.Y.heldMSec < ladderHoldMSec) startSnapHeading(chassis.get_absolute_heading());
+  else if (input.A.pressed) startMogoAlign();
+
+  switch (mode) {
+    case ASSIST_SNAP_HEADING: return updateSnapHeading(input);
+    case ASSIST_MOGO_ALIGN: return updateMogoAlign(input);
+    case ASSIST_DRIVE_TO_LADDER: return updateDriveToLadder(input);
+    default: return false;
+  }
+}
+
+/// @brief Stop whatever assist is running and leave the drive to the driver
+void DriverAssist::cancel() {
+  if (mode == ASSIST_DRIVE_TO_LADDER && !ladderDriveDone) {
+    ladderTask.stop();
+    ladderArmTask.stop();
+    arm.stop(hold);
+  }
+  if (mode != ASSIST_NONE) chassis.drive_stop(coast);
+  mode = ASSIST_NONE;
+}
+
+/// @brief Turn to the nearest multiple of snapHeadingStep
+/// @param currentHeading heading to snap from
+void DriverAssist::startSnapHeading(float currentHeading) {
+  cancel();
+  snapTargetHeading = reduce_0_to_360(round(currentHeading/snapHeadingStep)*snapHeadingStep);
+  snapPreviousError = reduce_negative_180_to_180(snapTargetHeading - currentHeading);
+  snapSettledMSec = 0;
+  mode = ASSIST_SNAP_HEADING;
+}
+
+/// @brief One tick of snap to heading.  Throttle stays with the driver so they can keep driving while it turns
+bool DriverAssist::updateSnapHeading(const DriverInput& input) {
+  if (isStickOverride(input.Axis1)) {
+    cancel();
+    return false;
+  }
+
+  float error = reduce_negative_180_to_180(snapTargetHeading - chassis.get_absolute_heading());
+  float turnVolts = chassis.turn_kp*error + chassis.turn_kd*(error - snapPreviousError);
+  turnVolts = clamp(turnVolts, -chassis.turn_max_voltage, chassis.turn_max_voltage);
+  snapPreviousError = error;
+
+  if (fabs(error) < chassis.turn_settle_error) snapSettledMSec += input.tickMSec;
+  else snapSettledMSec = 0;
+  if (snapSettledMSec >= snapSettleMSec) {
+    mode = ASSIST_NONE;
+    return false;
+  }
+
+  float throttleVolts = to_volt(deadband(input.Axis3, chassis.driver_deadband));
+  chassis.drive_with_turn_voltage(throttleVolts, turnVolts);
+  return true;
+}
+
+/// @brief Start backing onto the mogo behind the robot
+void DriverAssist::startMogoAlign() {
+  cancel();
+  mode = ASSIST_MOGO_ALIGN;
+}
+
+/// @brief One tick of mogo align.  The driver can still steer with the turn stick on the way in
+bool DriverAssist::updateMogoAlign(const DriverInput& input) {
+  if (isStickOverride(input.Axis3)) {
+    cancel();
+    return false;
+  }
+
+  double mogoDistance = backDistanceSensor.objectDistance(distanceUnits::mm);
+  if (mogoDistance > mogoSearchDistanceMM) {  //Nothing behind us, give up
+    cancel();
+    return false;
+  }
+  if (mogoDistance <= mogoClampDistanceMM) {  //Mogo is in the clamp
+    clampMogo();
+    chassis.drive_stop(brake);
+    mode = ASSIST_NONE;
+    return false;
+  }
+
+  float backVolts = clamp(mogoAlignKp*(mogoDistance - mogoClampDistanceMM), mogoAlignMinVoltage, mogoAlignMaxVoltage);
+  float turnVolts = to_volt(deadband(input.Axis1, chassis.driver_deadband));
+  chassis.drive_with_turn_voltage(-backVolts, turnVolts);
+  return true;
+}
+
+/// @brief Drive to the closest ladder face, pointing at the ladder, with the arm going up on the way
+void DriverAssist::startDriveToLadder() {
+  cancel();
+
+  //Pick the ladder face closest to where we are now
+  float bearingFromLadder = to_deg(atan2(chassis.get_X_position() - ladderCenterX, chassis.get_Y_position() - ladderCenterY));
+  float faceAngle = ladderFirstFaceAngle + round((bearingFromLadder - ladderFirstFaceAngle)/90.0)*90.0;
+  ladderTargetX = ladderCenterX + sin(to_rad(faceAngle))*ladderApproachDistance;
+  ladderTargetY = ladderCenterY + cos(to_rad(faceAngle))*ladderApproachDistance;
+  ladderTargetHeading = reduce_0_to_360(faceAngle + 180.0);
+
+  ladderDriveDone = false;
+  ladderTask = vex::task(driveToLadderTask, vex::task::taskPriorityNormal);
+  ladderArmTask = vex::task(spinArmUpForLadder, vex::task::taskPriorityNormal);
+  mode = ASSIST_DRIVE_TO_LADDER;
+}
+
+/// @brief One tick of the ladder drive.  The drive itself runs on ladderTask; this just watches for the end or an override
+bool DriverAssist::updateDriveToLadder(const DriverInput& input) {
+  if (isStickOverride(input.Axis3) || isStickOverride(input.Axis1)) {
+    cancel();
+    return false;
+  }
+  if (ladderDriveDone) {
+    mode = ASSIST_NONE;
+    return false;
+  }
+  return true;
+}
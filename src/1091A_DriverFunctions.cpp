@@ -5,6 +5,8 @@
 /*  These are our Driver control Functions                                   */
 /*---------------------------------------------------------------------------*/
 //Mogo Functions
+extern const double mogoClampDistanceMM = 40.0;
+
 void clampMogo(void) {
   mogo.set(true);
 }
@@ -24,47 +26,24 @@ void raiseDoinker(void) {
 
 //Conveyor Functions
 
+/// @brief Check if the optical sensor is looking at a ring of the color we are rejecting
+/// @param hue current optical sensor hue
+bool isUnwantedRing(double hue) {
+  if(rejectRedRings) return hue < 25;  //Red Hue is generally around 20 or lower
+  return hue > 150;  //Blue Hue is generally 210 or higher
+}
+
 /// @brief Check if the ring we are seeing is unwanted color and reject it
-/// @brief Called in a loop in conveyor button function and auton color sorting task
+/// @brief Called in a loop by the auton color sorting task (blocks while the bad ring flies off)
 void checkAndFilterBadRing() {
   //When color sensor sees the the rings we want to reject, stop conveyor momentarily so that the ring flies off
-  if(rejectRedRings) { //Reject Red Rings
-    if (myOptical.hue() < 25) { //Red Hue is generally around 20 or lower
-      task::sleep(13); //Wait a bit before stopping conveyor
-      intakeAndConveyor.stop();
-      waitUntil((myOptical.hue() > 25));      
-      task::sleep(15); //Wait a bit before restrating conveyor
-      intakeAndConveyor.spin(forward);
-    }
-  }
-  else {  //Reject Blue Rings
-    if (myOptical.hue() > 150) {  //Blue Hue is generally 210 or higher
-      task::sleep(13); //Wait a bit before stopping conveyor
-      intakeAndConveyor.stop();
-      waitUntil((myOptical.hue() < 150));      
-      task::sleep(15); //Wait a bit before restrating conveyor
-      intakeAndConveyor.spin(forward);
-    }
-  }
-}
-
-//Spins Intake and conveyor forward (take in rings and score); while looking for ring to reject
-void spinConveyorForward(void) {
-  while (Controller1.ButtonL1.pressing()) {
+  if (isUnwantedRing(myOptical.hue())) {
+    task::sleep(13); //Wait a bit before stopping conveyor
+    intakeAndConveyor.stop();
+    waitUntil(!isUnwantedRing(myOptical.hue()));
+    task::sleep(15); //Wait a bit before restrating conveyor
     intakeAndConveyor.spin(forward);
-    checkAndFilterBadRing();
-    task::sleep(5);
-  }
-  intakeAndConveyor.stop();
-}
-
-//Spins Intake and conveyor in reverse
-void spinConveyorReverse(void) {
-  while (Controller1.ButtonL2.pressing()) {
-    intakeAndConveyor.spin(reverse);
-  task::sleep(5);
   }
-  intakeAndConveyor.stop();
 }
 
 //Arm Functions
@@ -79,31 +58,6 @@ void gotoReceiveRingPosition(void) {
   arm.stop(hold);
 }
 
-// Raise the Arm (when Up Button is pressed)
-void rotateArmForward(void) {
-  arm.setStopping(brakeType::hold);
-  arm.setVelocity(80.0, percent); //Above 60% RPM, torque drops (but we need speed too)
-  while ((Controller1.ButtonUp.pressing() && armRotation.position(degrees) < 147.5)) {  //was 150 degrees
-    arm.spin(reverse);
-  task::sleep(5);
-  }
-  arm.stop(hold);
-}
-
-// Rotate Arm back when down button is pressed
-void rotateArmBack(void) {
-  arm.setStopping(brakeType::hold);
-  arm.setVelocity(100.0, percent);
-  while (Controller1.ButtonDown.pressing()) {
-    arm.spin(forward);
-    if (armRotation.position(degrees) < 20.0) {
-      arm.setStopping(brakeType::coast);
-    }
-  task::sleep(5);
-  }
-  arm.stop(coast);
-}
-
 // Hit the ring a few times to lock it into the arm (when right button is pressed)
 void lockRing(void) {
   if (armRotation.position(degrees) > 15.0 && armRotation.position(degrees) < 40.0) { //Only do this if the arm is in ring receiving position
@@ -117,4 +71,178 @@ void lockRing(void) {
     conveyor.spinFor(reverse, 67.5, degrees, false); //At the end spin conveyor back a bit so that conveyor hook gets out of the ring's way
     //conveyor.stop();
   }
-}
\ No newline at end of file
+}
+
+/*---------------------------------------------------------------------------*/
+/*  Driver control subsystem state machines                                  */
+/*  Each update function is called once per usercontrol() tick with the      */
+/*  same input snapshot, does one step of work and returns straight away.    */
+/*---------------------------------------------------------------------------*/
+
+//Conveyor sorting states (same timing as checkAndFilterBadRing, but without blocking)
+enum ConveyorSortState { SORT_WATCHING, SORT_WAIT_TO_STOP, SORT_STOPPED, SORT_WAIT_TO_RESTART };
+static ConveyorSortState conveyorSortState = SORT_WATCHING;
+static double conveyorSortTime = 0.0;
+
+//Arm states
+enum ArmState { ARM_IDLE, ARM_TO_RECEIVE, ARM_RAISING, ARM_LOWERING };
+static ArmState armState = ARM_IDLE;
+
+/// @brief L1 spins intake and conveyor forward (while sorting out bad rings), L2 spins them in reverse
+/// @param input this tick's controller snapshot
+void updateConveyor(const DriverInput& input) {
+  if (input.L1.pressing) {
+    if (input.L1.pressed) conveyorSortState = SORT_WATCHING;
+    switch (conveyorSortState) {
+      case SORT_WATCHING:
+        intakeAndConveyor.spin(forward);
+        if (isUnwantedRing(myOptical.hue())) {
+          conveyorSortState = SORT_WAIT_TO_STOP;
+          conveyorSortTime = input.timeMSec;
+        }
+        break;
+      case SORT_WAIT_TO_STOP:  //Wait a bit before stopping conveyor
+        if (input.timeMSec - conveyorSortTime >= 13.0) {
+          intakeAndConveyor.stop();
+          conveyorSortState = SORT_STOPPED;
+        }
+        break;
+      case SORT_STOPPED:  //Stay stopped until the ring has flown off
+        if (!isUnwantedRing(myOptical.hue())) {
+          conveyorSortState = SORT_WAIT_TO_RESTART;
+          conveyorSortTime = input.timeMSec;
+        }
+        break;
+      case SORT_WAIT_TO_RESTART:  //Wait a bit before restarting conveyor
+        if (input.timeMSec - conveyorSortTime >= 15.0) {
+          intakeAndConveyor.spin(forward);
+          conveyorSortState = SORT_WATCHING;
+        }
+        break;
+    }
+  }
+  else if (input.L2.pressing) {
+    intakeAndConveyor.spin(reverse);
+  }
+  else if (input.L1.released || input.L2.released) {
+    intakeAndConveyor.stop();
+  }
+}
+
+/// @brief Left brings the arm to ring receive position, Up raises the arm while held, Down lowers it while held
+/// @param input this tick's controller snapshot
+void updateArm(const DriverInput& input) {
+  //Manual Up/Down always take over from the receive position move
+  if (input.Up.pressed) {
+    armState = ARM_RAISING;
+    arm.setStopping(brakeType::hold);
+    arm.setVelocity(80.0, percent); //Above 60% RPM, torque drops (but we need speed too)
+  }
+  else if (input.Down.pressed) {
+    armState = ARM_LOWERING;
+    arm.setStopping(brakeType::hold);
+    arm.setVelocity(100.0, percent);
+  }
+  else if (input.Left.pressed && armState == ARM_IDLE) {
+    armState = ARM_TO_RECEIVE;
+    arm.setStopping(brakeType::hold);
+    arm.setVelocity(50.0, percent);
+  }
+
+  switch (armState) {
+    case ARM_IDLE:
+      break;
+    case ARM_TO_RECEIVE:
+      if (armRotation.position(degrees) < 24.0) arm.spin(reverse);  //was 32
+      else {
+        arm.stop(hold);
+        armState = ARM_IDLE;
+      }
+      break;
+    case ARM_RAISING:
+      if (input.Up.pressing && armRotation.position(degrees) < 147.5) arm.spin(reverse);  //was 150 degrees
+      else {
+        arm.stop(hold);
+        if (!input.Up.pressing) armState = ARM_IDLE;
+      }
+      break;
+    case ARM_LOWERING:
+      if (input.Down.pressing) {
+        arm.spin(forward);
+        if (armRotation.position(degrees) < 20.0) arm.setStopping(brakeType::coast);
+      }
+      else {
+        arm.stop(coast);
+        armState = ARM_IDLE;
+      }
+      break;
+  }
+}
+
+/// @brief R1/R2 clamp and release the mogo, X/B lower and raise the doinker, Right locks the ring in the arm
+/// @param input this tick's controller snapshot
+void updatePneumatics(const DriverInput& input) {
+  if (input.R1.pressed) clampMogo();
+  if (input.R2.pressed) releaseMogo();
+
+  if (input.X.pressed) lowerDoinker();
+  if (input.B.pressed) raiseDoinker();
+
+  if (input.Right.pressed) lockRing();
+}
+
+//Driver feedback on the controller
+const double driverFeedbackMSec = 100.0;  //How often the status lines are rebuilt
+const double motorHotCelsius = 55.0;  //Motors start cutting their power at 55C
+const double motorCooledCelsius = 50.0;  //Warn again only after every motor has cooled below this
+
+static double driverFeedbackTime = -1000.0;
+static bool motorsHot = false;
+static bool mogoInReach = false;
+
+/// @brief Hottest of a list of motors, in Celsius
+static double hottest(motor* const motors[], int count) {
+  double result = 0.0;
+  for (int ii = 0; ii < count; ii++) result = std::max(result, motors[ii]->temperature(temperatureUnits::celsius));
+  return(result);
+}
+
+/// @brief Mogo clamp, motor temperatures and sort color on the controller screen.  A tap when a goal reaches the
+/// @brief open clamp, and a long buzz when a motor gets hot.  The lines are only handed to controllerFeedback;
+/// @brief nothing here waits on the radio
+/// @param input this tick's controller snapshot
+void updateDriverFeedback(const DriverInput& input) {
+  if (input.timeMSec - driverFeedbackTime < driverFeedbackMSec) return;
+  driverFeedbackTime = input.timeMSec;
+
+  bool clamped = mogo.value();
+  bool inReach = backDistanceSensor.objectDistance(distanceUnits::mm) <= mogoClampDistanceMM;
+  if (inReach && !mogoInReach && !clamped) controllerFeedback.rumble(RUMBLE_CONFIRM);
+  mogoInReach = inReach;
+  controllerFeedback.setLine(0, "Mogo %s", clamped ? "CLAMPED" : inReach ? "open  GOAL IN" : "open");
+
+  static motor* const driveMotors[] = {&LF, &LT, &LB, &RF, &RT, &RB};
+  double driveCelsius = hottest(driveMotors, 6);
+  double intakeCelsius = intake.temperature(temperatureUnits::celsius);
+  double conveyorCelsius = conveyor.temperature(temperatureUnits::celsius);
+  double armCelsius = arm.temperature(temperatureUnits::celsius);
+  double hottestCelsius = std::max(std::max(driveCelsius, intakeCelsius), std::max(conveyorCelsius, armCelsius));
+  if (hottestCelsius >= motorHotCelsius && !motorsHot) {
+    motorsHot = true;
+    controllerFeedback.rumble(RUMBLE_WARNING);
+  }
+  else if (hottestCelsius < motorCooledCelsius) motorsHot = false;
+  controllerFeedback.setLine(1, "D%.0f I%.0f C%.0f A%.0f%s", driveCelsius, intakeCelsius, conveyorCelsius, armCelsius,
+    motorsHot ? " HOT" : "");
+
+  controllerFeedback.setLine(2, "Rej %s Bat %d%%", rejectRedRings ? "RED" : "BLUE", (int) Brain.Battery.capacity());
+}
+
+/// @brief Run one tick of every driver controlled mechanism
+/// @param input this tick's controller snapshot
+void updateDriverSubsystems(const DriverInput& input) {
+  updateConveyor(input);
+  updateArm(input);
+  updatePneumatics(input);
+  updateDriverFeedback(input);
+}
@@ -0,0 +1,50 @@
+#include "vex.h"
+
+/*---------------------------------------------------------------------------*/
+/*  Driver control input layer                                               */
+/*  The controller is read exactly once per usercontrol() tick. Subsystems   */
+/*  look at the edges/levels below instead of registering pressed() events,  */
+/*  so two buttons held together are handled in the same tick.               */
+/*---------------------------------------------------------------------------*/
+
+/// @brief Update the button with this tick's reading and work out the edges
+/// @param isPressing whether the button is down right now
+/// @param tickMSec time since the previous reading
+void ButtonState::update(bool isPressing, double tickMSec) {
+  pressed = isPressing && !pressing;
+  released = !isPressing && pressing;
+
+  //Hold time is kept on the release tick so a tap can be told apart from a hold
+  if (isPressing) heldMSec = pressed ? 0.0 : heldMSec + tickMSec;
+  else if (!released) heldMSec = 0.0;
+
+  pressing = isPressing;
+}
+
+/// @brief Take a snapshot of every button and stick on the controller
+/// @param c controller to read (normally Controller1)
+void DriverInput::sample(controller& c) {
+  double now = Brain.Timer.value()*1000.0;
+  tickMSec = (timeMSec > 0.0) ? now - timeMSec : 0.0;
+  timeMSec = now;
+
+  L1.update(c.ButtonL1.pressing(), tickMSec);
+  L2.update(c.ButtonL2.pressing(), tickMSec);
+  R1.update(c.ButtonR1.pressing(), tickMSec);
+  R2.update(c.ButtonR2.pressing(), tickMSec);
+
+  Up.update(c.ButtonUp.pressing(), tickMSec);
+  Down.update(c.ButtonDown.pressing(), tickMSec);
+  Left.update(c.ButtonLeft.pressing(), tickMSec);
+  Right.update(c.ButtonRight.pressing(), tickMSec);
+
+  X.update(c.ButtonX.pressing(), tickMSec);
+  B.update(c.ButtonB.pressing(), tickMSec);
+  Y.update(c.ButtonY.pressing(), tickMSec);
+  A.update(c.ButtonA.pressing(), tickMSec);
+
+  Axis1 = c.Axis1.value();
+  Axis2 = c.Axis2.value();
+  Axis3 = c.Axis3.value();
+  Axis4 = c.Axis4.value();
+}
@@ -5,115 +5,115 @@
 /* ****************************************************************************** */
 
 
-/* ************** */
-/* Turn Functions */
-/* ************** */
-void Drive::turn_to_heading_1091A(float targetHeading) {
-  turn_to_heading_1091A(targetHeading, turn_max_voltage, turn_settle_error, turn_timeout, turn_kp, turn_ki, turn_kd, turn_starti);
-}
-
-void Drive::turn_to_heading_1091A(float targetHeading, float turn_max_voltage, float turn_settle_error, float turn_timeout, float turn_kp, float turn_ki, float turn_kd, float turn_starti) {
-  float startingHeading = Gyro.heading();
-
-  bool isTargetLTCurrent = targetHeading < startingHeading;
-  bool isTurnLeft = false;
-
-  //Figure out how many degrees to turn
-  float degreesToTurn = fabs(static_cast<float>(startingHeading - targetHeading));
-  bool isDiffLT180 = degreesToTurn < 180.0;
-
-  //If degrees to turn is >180, then normalize it to the opposite angle
-  if (!isDiffLT180) degreesToTurn = fabs(static_cast<float>(360.0 - degreesToTurn));
-
-  //Figure out whether to turn left or right
-  if ((isDiffLT180 && isTargetLTCurrent) || (!isDiffLT180 && !isTargetLTCurrent)) isTurnLeft = false;  // Turn Right
-  else isTurnLeft = true; //Turn Left
-
-  //degreesToTurn = degreesToTurn - turn_settle_error;
-
-  if (degreesToTurn > 0.0) {
-    Gyro.setRotation(0.0, degrees);
-    float degreesTurned = 0.0;
-    float error = 0.0;
-    float previousError = 0.0;
-    float derivative = 0.0;
-    float integral = 0.0;
-    float currentVolts = static_cast<float>(fabs(turn_max_voltage));
-    long loopCount = 0;
-    double setTime = Brain.Timer.value();
-    double gyroReadingDelayInMSec = 10.0;
-
-    //While we have not timed out, and have not yet turned enough (or have turned too much)
-    while ((Brain.Timer.value() - setTime)*1000.0 < turn_timeout \
-            && ((degreesTurned < (degreesToTurn - turn_settle_error)) \
-             || (degreesTurned > (degreesToTurn + turn_settle_error)))) {
-      loopCount++;
-      if (isTurnLeft) drive_with_voltage(-currentVolts, currentVolts);  //For left turn, left side is -ve volts, Right side is +ve volts
-      else drive_with_voltage(currentVolts, -currentVolts); //For right turn, Left side is +ve volts, Right side is -ve volts
-
-      //Wait a bit before reading the Gyro (but never less than 5 msec)
-      if((gyroReadingDelayInMSec / loopCount) < 2.0) task::sleep(2);
-      else task::sleep(static_cast<uint32_t>(gyroReadingDelayInMSec / loopCount));
-
-      //Read how much we have turned and normalize the amount turned
-      degreesTurned = fabs(static_cast<float>(Gyro.rotation())*(360.0/gyro_scale));
-      if (degreesTurned > 180.0) degreesTurned = fabs(static_cast<float>(degreesTurned - 360.0));
-
-      //PID calculations
-      error = (degreesToTurn - degreesTurned);
-      if (fabs(error) < turn_starti) integral+=error;
-      // Check if error has crossed the zero line, and if it has, eliminates the integral term
-      // and reverse the turn direction (we only cross the zero line when we are trying to settle into a steady state)
-      if ((error>0 && previousError<0)||(error<0 && previousError>0)){ 
-        integral = 0; 
-        isTurnLeft = !isTurnLeft;
-      }
-      derivative = error - previousError;
-      previousError = error;
-      
-      //Now calculate the new voltage to give the motors
-      currentVolts = static_cast<float>(fabs(turn_max_voltage)) * ((error * turn_kp) + (derivative * turn_kd) + (integral * turn_ki))/degreesToTurn;
-
-      //If the new voltage is below the minimum volts we need, then set the volts to the minimum volts
-      if(currentVolts <2.0) currentVolts = 2.0;
-    }
-    if(isTurnLeft){ //On Left turns, stop the right motors first
-      DriveR.stop(hold);
-      DriveL.stop(hold);
-    }
-    else{ //On Right turns, stop the left motors first
-      DriveL.stop(hold);
-      DriveR.stop(hold);
-    }
-    task::sleep(10);
-  }
-}
+/* Turns go through the single turn engine in Drive::turn_to_angle() (see the turn presets in autons.cpp) */
 
 
 /* ************** */
 /* Drive Functions */
 /* ************** */
 void Drive::drive_distance_1091A(float distance, float heading, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti){
-  PID drivePID(distance, drive_kp, drive_ki, drive_kd, drive_starti, drive_settle_error, drive_settle_time, drive_timeout);
+  drive_params params = {drive_max_voltage, drive_min_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, {drive_kp, drive_ki, drive_kd, drive_starti}, {heading_kp, heading_ki, heading_kd, heading_starti}, boomerang_lead, boomerang_setback};
+  drive_distance_1091A(distance, heading, params);
+}
 
-  float start_average_position = ForwardTracker_diameter*M_PI*R_ForwardTracker.position(degrees)/360.0;
+void Drive::drive_distance_1091A(float distance, float heading, const drive_params &params){
+  PID drivePID(distance, params.drive.kp, params.drive.ki, params.drive.kd, params.drive.starti, params.settle_error, params.settle_time, params.timeout);
+  PID headingPID(reduce_negative_180_to_180(heading - get_absolute_heading()), params.heading.kp, params.heading.ki, params.heading.kd, params.heading.starti);
+
+  float start_average_position = get_ForwardTracker_position();
   float average_position = start_average_position;
   float drive_error = distance;
   
-  while((fabs(drive_error) >= fabs(drive_settle_error)) || !drivePID.is_settled()){
-    average_position = ForwardTracker_diameter*M_PI*R_ForwardTracker.position(degrees)/360.0;
+  while((fabs(drive_error) >= fabs(params.settle_error)) || !drivePID.is_settled()){
+    if (motion_terminated()) { break; }
+    average_position = get_ForwardTracker_position();
     float drive_remining = (distance+start_average_position-average_position);
-    float drive_volts = (drivePID.compute(drive_remining) * drive_max_voltage)/distance;
+    float drive_volts = (drivePID.compute(drive_remining) * params.max_voltage)/distance;
 
-    drive_volts = clamp(drive_volts, -drive_max_voltage, drive_max_voltage);
+    drive_volts = clamp(drive_volts, -params.max_voltage, params.max_voltage);
     //If the newly calculated drivevolts is less than 2.5, then make it 2.5 (while maintaining the +ve/-ve sign)
     if((drive_volts >= 0.0) && (drive_volts < 2.5)) drive_volts = 2.5;
     else if((drive_volts < 0.0) && (drive_volts > -2.5)) drive_volts = -2.5;
 
-    drive_with_voltage(drive_volts, drive_volts);
+    //Hold the heading we started with (outer heading loop + inner yaw rate loop)
+    float heading_volts = straight_heading_correction(headingPID, heading, params.heading_max_voltage);
+
+    drive_with_turn_voltage(drive_volts, heading_volts);
     task::sleep(5);
   }
   drive_stop(hold);
+  clear_terminators();
+}
+
+/// @brief Back into something (a mogo) at full speed using a distance sensor on the back, brake only as late as we have to,
+/// @brief and fire on_contact (e.g. the clamp) right as it reaches the contact distance.
+/// @param sensor distance sensor facing backwards
+/// @param contact_mm sensor reading when the object is where on_contact should grab it
+/// @param trigger_lead_msec how early to fire on_contact (piston travel time plus sensor lag), based on how fast we are closing in
+/// @param max_voltage voltage to back up with until we have to brake
+/// @param braking_decel how hard we can slow down, in mm/s per second, without tipping or skidding
+/// @param timeout give up after this many msec
+/// @param max_travel give up after backing up this many inches (on the forward tracker), so a missing object can't send us across the field
+/// @param on_contact called once when we reach the object
+/// @return true if we reached the object, false if we timed out, hit max_travel or never saw it
+bool Drive::back_to_contact_1091A(vex::distance &sensor, float contact_mm, float trigger_lead_msec, float max_voltage, float braking_decel, float timeout, float max_travel, void (*on_contact)()) {
+  const float loopMSec = 10.0;
+  const float filterWeight = 0.5;  //How much each new reading counts in the filtered distance and closing speed
+  const float maxValidMM = 2000.0;  //The sensor reads 9999 (or jumps around) when nothing is in range
+  const float minVolts = 2.5;  //Below this the drive stalls before it gets there
+
+  float holdHeading = get_absolute_heading();
+  PID headingPID(0, heading_kp, heading_ki, heading_kd, heading_starti);
+  float filteredMM = -1;
+  float closingSpeed = 0;  //mm per second, positive while we are getting closer
+  bool reached = false;
+  double startTime = Brain.Timer.value()*1000.0;
+  double previousTime = startTime;
+  float startPosition = get_ForwardTracker_position();
+
+  while (Brain.Timer.value()*1000.0 - startTime < timeout) {
+    if (motion_terminated()) break;
+    if (fabs(get_ForwardTracker_position() - startPosition) >= max_travel) break;
+
+    double now = Brain.Timer.value()*1000.0;
+    float readingMM = static_cast<float>(sensor.objectDistance(mm));
+    float dt = static_cast<float>(now - previousTime)/1000.0;
+    previousTime = now;
+
+    float volts = max_voltage;
+    if (readingMM < maxValidMM) {
+      if (filteredMM < 0) filteredMM = readingMM;
+      else {
+        float newFiltered = filteredMM + filterWeight*(readingMM - filteredMM);
+        if (dt > 0) closingSpeed += filterWeight*((filteredMM - newFiltered)/dt - closingSpeed);
+        filteredMM = newFiltered;
+      }
+
+      //Fire early enough that the clamp closes as the object gets to contact_mm
+      float predictedMM = filteredMM - closingSpeed*trigger_lead_msec/1000.0;
+      if (predictedMM <= contact_mm) {
+        on_contact();
+        reached = true;
+        break;
+      }
+
+      //Full speed until the braking distance, then the fastest speed we can still stop from in the distance left
+      float remainingMM = filteredMM - contact_mm;
+      float brakingMM = (closingSpeed*closingSpeed)/(2.0*braking_decel);
+      if (remainingMM <= brakingMM) {
+        float allowedSpeed = sqrt(2.0*braking_decel*remainingMM);
+        volts = max_voltage*allowedSpeed/fmax(closingSpeed, 1.0f);
+        volts = clamp(volts, minVolts, max_voltage);
+      }
+    }
+
+    float headingVolts = straight_heading_correction(headingPID, holdHeading, heading_max_voltage);
+    drive_with_turn_voltage(-volts, headingVolts);
+    task::sleep(static_cast<uint32_t>(loopMSec));
+  }
+  drive_stop(hold);
+  clear_terminators();
+  return reached;
 }
 
 /*
@@ -0,0 +1,175 @@
+#include "vex.h"
+
+/*---------------------------------------------------------------------------*/
+/*  Pre-match self-test                                                      */
+/*  Each device is one line in selfTestChecks, with the reading to watch     */
+/*  and its limits. The readings are folded into a running mean and         */
+/*  variance as they come in, so nothing is stored per sample.              */
+/*---------------------------------------------------------------------------*/
+
+static const float noLimit = 1.0e9;
+
+/// @brief One device to test
+struct SelfTestCheck {
+  const char* name;
+  device* tested;
+  float (*read)(device& tested);  //NAN when there is nothing to read (nothing in front of a distance sensor)
+  float maxNoise;
+  float maxDrift;
+  float maxValue;
+};
+
+static float rotationDegrees(device& tested) { return static_cast<rotation&>(tested).position(degrees); }
+static float opticalHue(device& tested) { return static_cast<optical&>(tested).hue(); }
+static float inertialDegrees(device& tested) { return static_cast<inertial&>(tested).rotation(); }
+static float motorCelsius(device& tested) { return static_cast<motor&>(tested).temperature(temperatureUnits::celsius); }
+
+static float distanceMM(device& tested) {
+  distance& sensor = static_cast<distance&>(tested);
+  return sensor.isObjectDetected() ? sensor.objectDistance(distanceUnits::mm) : NAN;
+}
+
+//Limits are for a robot that is not moving: a tracker or the arm that turns by more than a few tenths of a degree is
+//being bumped or has a loose magnet, and the gyro should drift far less than half a degree in 1.5 seconds
+static const SelfTestCheck selfTestChecks[] = {
+  {"odomX", &odomX, rotationDegrees, 0.2, 1.0, noLimit},
+  {"odomY", &odomY, rotationDegrees, 0.2, 1.0, noLimit},
+  {"armRotation", &armRotation, rotationDegrees, 0.5, 2.0, noLimit},
+  {"optical", &myOptical, opticalHue, noLimit, noLimit, 360.0},
+  {"frontDistance", &frontDistanceSensor, distanceMM, 15.0, noLimit, 2000.0},
+  {"backDistance", &backDistanceSensor, distanceMM, 15.0, noLimit, 2000.0},
+  {"inertial", &myInertial, inertialDegrees, 0.1, 0.5, noLimit},
+  {"LF", &LF, motorCelsius, noLimit, noLimit, 55.0},
+  {"LT", &LT, motorCelsius, noLimit, noLimit, 55.0},
+  {"LB", &LB, motorCelsius, noLimit, noLimit, 55.0},
+  {"RF", &RF, motorCelsius, noLimit, noLimit, 55.0},
+  {"RT", &RT, motorCelsius, noLimit, noLimit, 55.0},
+  {"RB", &RB, motorCelsius, noLimit, noLimit, 55.0},
+  {"conveyor", &conveyor, motorCelsius, noLimit, noLimit, 55.0},
+  {"intake", &intake, motorCelsius, noLimit, noLimit, 55.0},
+  {"arm", &arm, motorCelsius, noLimit, noLimit, 55.0},
+};
+
+const int selfTestDeviceCount = sizeof(selfTestChecks)/sizeof(selfTestChecks[0]);
+SelfTestReport selfTestReports[selfTestDeviceCount];
+int selfTestFailures = 0;
+
+/// @brief Running statistics for one device
+struct SelfTestSamples {
+  bool connected = true;
+  bool heard = false;
+  uint32_t lastTimestamp = 0;
+  double lastNewDataMSec = 0;
+  double worstGapMSec = 0;
+  int count = 0;
+  double mean = 0, sumSquares = 0;  //Welford's running mean and sum of squared differences
+  float first = 0, last = 0, highest = -noLimit;
+
+  void add(float value) {
+    if (isnan(value)) return;
+    if (count == 0) first = value;
+    count++;
+    double delta = value - mean;
+    mean += delta/count;
+    sumSquares += delta*(value - mean);
+    last = value;
+    highest = std::max(highest, value);
+  }
+};
+
+/// @brief Read every device for selfTestMSec, then fill selfTestReports and report any failures
+/// @return number of devices that failed
+int runSelfTest() {
+  static SelfTestSamples samples[selfTestDeviceCount];
+  double startMSec = Brain.Timer.value()*1000.0;
+  double nowMSec = startMSec;
+
+  while (nowMSec - startMSec < selfTestMSec) {
+    for (int ii = 0; ii < selfTestDeviceCount; ii++) {
+      const SelfTestCheck& check = selfTestChecks[ii];
+      SelfTestSamples& sample = samples[ii];
+      if (!check.tested->installed()) {
+        sample.connected = false;
+        continue;
+      }
+      //The timestamp changes each time the device sends new data
+      uint32_t timestamp = static_cast<uint32_t>(check.tested->timestamp());
+      if (!sample.heard || timestamp != sample.lastTimestamp) {
+        if (sample.heard) sample.worstGapMSec = std::max(sample.worstGapMSec, nowMSec - sample.lastNewDataMSec);
+        sample.heard = true;
+        sample.lastTimestamp = timestamp;
+        sample.lastNewDataMSec = nowMSec;
+      }
+      sample.add(check.read(*check.tested));
+    }
+    task::sleep(selfTestSampleMSec);
+    nowMSec = Brain.Timer.value()*1000.0;
+  }
+
+  selfTestFailures = 0;
+  for (int ii = 0; ii < selfTestDeviceCount; ii++) {
+    const SelfTestCheck& check = selfTestChecks[ii];
+    const SelfTestSamples& sample = samples[ii];
+    SelfTestReport& report = selfTestReports[ii];
+    report.name = check.name;
+    report.worstGapMSec = std::max(sample.worstGapMSec, nowMSec - sample.lastNewDataMSec);
+    report.noise = (sample.count > 1) ? sqrt(sample.sumSquares/(sample.count - 1)) : 0;
+    report.drift = sample.last - sample.first;
+    report.highest = sample.highest;
+
+    if (!sample.connected) report.fault = SELF_TEST_UNPLUGGED;
+    else if (report.worstGapMSec > selfTestMaxGapMSec) report.fault = SELF_TEST_STALE;
+    else if (sample.count > 0 && report.highest > check.maxValue) report.fault = SELF_TEST_OUT_OF_RANGE;
+    else if (report.noise > check.maxNoise) report.fault = SELF_TEST_NOISY;
+    else if (fabs(report.drift) > check.maxDrift) report.fault = SELF_TEST_DRIFTING;
+    else report.fault = SELF_TEST_OK;
+
+    if (report.fault != SELF_TEST_OK) {
+      selfTestFailures++;
+      printf("self test: %s %s (gap %.0fms noise %.3f drift %.3f max %.1f)\n", report.name, selfTestFaultText(report.fault),
+        report.worstGapMSec, report.noise, report.drift, report.highest);
+    }
+  }
+
+  if (selfTestFailures > 0) {
+    controllerFeedback.rumble(RUMBLE_WARNING);
+    controllerFeedback.setLine(0, "SELF TEST %d FAIL", selfTestFailures);
+    for (int ii = 0, row = 1; ii < selfTestDeviceCount && row < controllerLineCount; ii++) {
+      if (selfTestReports[ii].fault == SELF_TEST_OK) continue;
+      controllerFeedback.setLine(row++, "%s %s", selfTestReports[ii].name, selfTestFaultText(selfTestReports[ii].fault));
+    }
+  }
+  return(selfTestFailures);
+}
+
+/// @brief Short description of a fault for the screens
+const char* selfTestFaultText(SelfTestFault fault) {
+  switch (fault) {
+    case SELF_TEST_OK: return "ok";
+    case SELF_TEST_UNPLUGGED: return "unplugged";
+    case SELF_TEST_STALE: return "stale";
+    case SELF_TEST_OUT_OF_RANGE: return "too high";
+    case SELF_TEST_NOISY: return "noisy";
+    case SELF_TEST_DRIFTING: return "drift";
+  }
+  return "";
+}
+
+/// @brief Put the self-test result on the dashboard, one failure at a time, changing every 2 seconds
+/// @param timeMSec Brain timer in msec
+void showSelfTest(double timeMSec) {
+  if (selfTestFailures == 0) {
+    dashboard.setTextColor(DASH_SELF_TEST, color::black);
+    dashboard.setText(DASH_SELF_TEST, "Self test OK (%d devices)", selfTestDeviceCount);
+    return;
+  }
+  int shown = static_cast<int>(timeMSec/2000.0) % selfTestFailures;
+  for (int ii = 0; ii < selfTestDeviceCount; ii++) {
+    if (selfTestReports[ii].fault == SELF_TEST_OK) continue;
+    if (shown-- > 0) continue;
+    dashboard.setTextColor(DASH_SELF_TEST, color::red);
+    dashboard.setText(DASH_SELF_TEST, "%d/%d %s %s", static_cast<int>(timeMSec/2000.0) % selfTestFailures + 1, selfTestFailures,
+      selfTestReports[ii].name, selfTestFaultText(selfTestReports[ii].fault));
+    return;
+  }
+}
@@ -0,0 +1,335 @@
+#include "vex.h"
+#include "globals.h"
+#include <stdarg.h>
+
+/*---------------------------------------------------------------------------*/
+/*  PID tuning console                                                       */
+/*  Edits the presets in robotConfig in place, so a test run and the autons  */
+/*  use exactly the same values. The test motions call the real              */
+/*  turn_to_heading_* and drive_distance_* functions, and a low priority     */
+/*  task watches the error while they run to measure overshoot and settle    */
+/*  time.                                                                    */
+/*---------------------------------------------------------------------------*/
+
+bool tuningConsoleActive = false;
+
+//Names on the screen (the same words the SD auton scripts use)
+static const char* const turnPresetNames[TURN_PRESET_COUNT] = {
+  "turn_tiny", "turn_small", "turn_medium", "turn_large", "turn_xlarge", "adjust"};
+static const char* const drivePresetNames[DRIVE_PRESET_COUNT] = {"drive_small", "drive_medium", "drive_large"};
+
+//Test motion sizes, picked from the middle of the range each preset is meant for
+static const float turnTestDegrees[TURN_PRESET_COUNT] = {20, 45, 90, 135, 180, 5};
+static const float driveTestInches[DRIVE_PRESET_COUNT] = {12, 24, 48};
+
+static void (*const turnPresetFunctions[TURN_PRESET_XLARGE + 1])(float, float) = {
+  turn_to_heading_tiny, turn_to_heading_small, turn_to_heading_medium, turn_to_heading_large, turn_to_heading_xlarge};
+static void (*const drivePresetFunctions[DRIVE_PRESET_COUNT])(float) = {
+  drive_distance_small, drive_distance_medium, drive_distance_large};
+
+/// @brief One value the console can change, with its step at step scale x1
+struct TuningField {
+  const char* label;
+  float step;
+};
+
+static const TuningField turnFields[] = {
+  {"max volts", 0.5}, {"kp", 0.01}, {"ki", 0.005}, {"kd", 0.05}, {"starti", 1.0}, {"settle err", 0.1}, {"settle ms", 10},
+};
+static const TuningField driveFields[] = {
+  {"max volts", 0.5}, {"kp", 0.05}, {"ki", 0.01}, {"kd", 0.1}, {"starti/in", 0.05},
+  {"head kp", 0.05}, {"head kd", 0.1}, {"settle err", 0.05}, {"settle ms", 10},
+};
+const int turnFieldCount = sizeof(turnFields)/sizeof(turnFields[0]);
+const int driveFieldCount = sizeof(driveFields)/sizeof(driveFields[0]);
+
+const int tuningPresetCount = TURN_PRESET_COUNT + DRIVE_PRESET_COUNT;  //Turns first, then drives
+const double tuningRepeatDelayMSec = 400.0;
+const double tuningRepeatMSec = 100.0;
+const double tuningExitHoldMSec = 1000.0;
+
+//Brain screen layout (480 x 240)
+const int tuningRowTop = 30;
+const int tuningRowHeight = 22;
+const int tuningResultX = 250;
+const int runButtonX = 250, saveButtonX = 365, buttonY = 185, buttonWidth = 105, buttonHeight = 50;
+
+static float* turnFieldValue(turn_params& p, int field) {
+  switch (field) {
+    case 0: return &p.max_voltage;
+    case 1: return &p.gains.kp;
+    case 2: return &p.gains.ki;
+    case 3: return &p.gains.kd;
+    case 4: return &p.gains.starti;
+    case 5: return &p.settle_error;
+    default: return &p.settle_time;
+  }
+}
+
+static float* driveFieldValue(drive_params& p, int field) {
+  switch (field) {
+    case 0: return &p.max_voltage;
+    case 1: return &p.drive.kp;
+    case 2: return &p.drive.ki;
+    case 3: return &p.drive.kd;
+    case 4: return &p.drive.starti;
+    case 5: return &p.heading.kp;
+    case 6: return &p.heading.kd;
+    case 7: return &p.settle_error;
+    default: return &p.settle_time;
+  }
+}
+
+static bool isTurnPreset(int preset) { return preset < TURN_PRESET_COUNT; }
+
+static const char* presetName(int preset) {
+  return isTurnPreset(preset) ? turnPresetNames[preset] : drivePresetNames[preset - TURN_PRESET_COUNT];
+}
+
+static int fieldCount(int preset) { return isTurnPreset(preset) ? turnFieldCount : driveFieldCount; }
+
+static const TuningField& fieldInfo(int preset, int field) {
+  return isTurnPreset(preset) ? turnFields[field] : driveFields[field];
+}
+
+static float* fieldValue(int preset, int field) {
+  if (isTurnPreset(preset)) return turnFieldValue(robotConfig.turnPresets[preset], field);
+  return driveFieldValue(robotConfig.drivePresets[preset - TURN_PRESET_COUNT], field);
+}
+
+static bool presetValid(int preset) {
+  if (isTurnPreset(preset)) return valid_turn_params(robotConfig.turnPresets[preset]);
+  return valid_drive_params(robotConfig.drivePresets[preset - TURN_PRESET_COUNT]);
+}
+
+/* ******************* */
+/* Test motion monitor */
+/* ******************* */
+static volatile bool monitorRunning = false;
+static bool monitorIsTurn = false;
+static float monitorTarget = 0;  //Heading for turns, inches from monitorStartPosition for drives
+static float monitorStartPosition = 0;
+static float monitorSettleError = 0;
+static TuningResult monitorResult;
+
+/// @brief Signed distance to the target of the test motion
+static float monitorError() {
+  if (monitorIsTurn) return reduce_negative_180_to_180(monitorTarget - chassis.get_absolute_heading());
+  return monitorTarget - (chassis.get_ForwardTracker_position() - monitorStartPosition);
+}
+
+/// @brief Watches the error while the test motion runs
+/// @return always returns zero since Vex::task class expects that
+static int tuningMonitorTask() {
+  double startMSec = Brain.Timer.value()*1000.0;
+  float moveSign = (monitorError() >= 0) ? 1 : -1;
+  bool wasInside = false;
+  while (monitorRunning) {
+    float error = monitorError();
+    float elapsed = static_cast<float>(Brain.Timer.value()*1000.0 - startMSec);
+    monitorResult.overshoot = fmax(monitorResult.overshoot, -error*moveSign);
+    bool inside = fabs(error) <= monitorSettleError;
+    if (inside && !wasInside) monitorResult.settleMSec = elapsed;
+    if (!inside) monitorResult.settleMSec = -1;
+    wasInside = inside;
+    task::sleep(5);
+  }
+  return 0;
+}
+
+/// @brief Run the preset's test motion, out from where the robot is or back again
+/// @param preset console preset index
+/// @param outbound true for the first half of the out-and-back
+/// @return how the motion went
+static TuningResult runTestMotion(int preset, bool outbound) {
+  float direction = outbound ? 1 : -1;
+  monitorResult = TuningResult();
+  monitorIsTurn = isTurnPreset(preset);
+  if (monitorIsTurn) {
+    monitorTarget = reduce_0_to_360(chassis.get_absolute_heading() + direction*turnTestDegrees[preset]);
+    monitorSettleError = robotConfig.turnPresets[preset].settle_error;
+    monitorResult.target = monitorTarget;
+  } else {
+    monitorTarget = direction*driveTestInches[preset - TURN_PRESET_COUNT];
+    monitorStartPosition = chassis.get_ForwardTracker_position();
+    monitorSettleError = robotConfig.drivePresets[preset - TURN_PRESET_COUNT].settle_error;
+    monitorResult.target = monitorTarget;
+  }
+
+  monitorRunning = true;
+  task monitor(tuningMonitorTask, task::taskPrioritylow);
+  double startMSec = Brain.Timer.value()*1000.0;
+  if (preset == TURN_PRESET_ADJUST_HEADING) {
+    adjustHeading(monitorTarget, monitorSettleError, robotConfig.turnPresets[preset].timeout);
+  } else if (monitorIsTurn) {
+    turnPresetFunctions[preset](monitorTarget, monitorSettleError);
+  } else {
+    drivePresetFunctions[preset - TURN_PRESET_COUNT](monitorTarget);
+  }
+  monitorResult.totalMSec = static_cast<float>(Brain.Timer.value()*1000.0 - startMSec);
+  task::sleep(10);  //Let the monitor see the end of the motion
+  monitorRunning = false;
+  monitor.stop();
+  chassis.drive_stop(hold);
+
+  monitorResult.finalError = monitorError();
+  monitorResult.valid = true;
+  return monitorResult;
+}
+
+/* ******* */
+/* Console */
+/* ******* */
+
+/// @brief True on the press and then every tuningRepeatMSec while the button stays down
+static bool repeatPressed(const ButtonState& button, double tickMSec) {
+  if (button.pressed || button.holdStarted(tuningRepeatDelayMSec, tickMSec)) return true;
+  if (!button.held(tuningRepeatDelayMSec)) return false;
+  double since = button.heldMSec - tuningRepeatDelayMSec;
+  return static_cast<int>(since/tuningRepeatMSec) != static_cast<int>((since - tickMSec)/tuningRepeatMSec);
+}
+
+static bool touchInside(int x, int y, int left, int top, int width, int height) {
+  return x >= left && x < left + width && y >= top && y < top + height;
+}
+
+/// @brief printf to the Brain screen (formatted here, since printAt's bool overload makes some argument lists ambiguous)
+static void printTuningAt(int x, int y, const char* format, ...) {
+  char line[48];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  Brain.Screen.printAt(x, y, line);
+}
+
+/// @brief Brain screen: the preset's values on the left, the last run and the RUN/SAVE buttons on the right
+static void drawTuningScreen(int preset, int field, float stepScale, const TuningResult& result, const char* status) {
+  Brain.Screen.clearScreen();
+  Brain.Screen.setFont(fontType::mono20);
+  Brain.Screen.setFillColor(color::black);
+  printTuningAt(5, 20, "PID TUNER %-14s step x%g", presetName(preset), stepScale);
+
+  for (int ii = 0; ii < fieldCount(preset); ii++) {
+    Brain.Screen.setFillColor(ii == field ? color::blue : color::black);
+    printTuningAt(5, tuningRowTop + tuningRowHeight*(ii + 1), "%-10s %9.3f", fieldInfo(preset, ii).label, *fieldValue(preset, ii));
+  }
+
+  Brain.Screen.setFillColor(color::black);
+  const char* unit = isTurnPreset(preset) ? "deg" : "in";
+  if (result.valid) {
+    printTuningAt(tuningResultX, tuningRowTop + tuningRowHeight, "target %7.1f %s", result.target, unit);
+    printTuningAt(tuningResultX, tuningRowTop + tuningRowHeight*2, "over   %7.2f %s", result.overshoot, unit);
+    if (result.settleMSec >= 0) printTuningAt(tuningResultX, tuningRowTop + tuningRowHeight*3, "settle %7.0f ms", result.settleMSec);
+    else Brain.Screen.printAt(tuningResultX, tuningRowTop + tuningRowHeight*3, "settle   never");
+    printTuningAt(tuningResultX, tuningRowTop + tuningRowHeight*4, "total  %7.0f ms", result.totalMSec);
+    printTuningAt(tuningResultX, tuningRowTop + tuningRowHeight*5, "error  %7.2f %s", result.finalError, unit);
+  }
+  Brain.Screen.printAt(tuningResultX, tuningRowTop + tuningRowHeight*6, status);
+
+  Brain.Screen.setFillColor(color::green);
+  Brain.Screen.drawRectangle(runButtonX, buttonY, buttonWidth, buttonHeight);
+  Brain.Screen.printAt(runButtonX + 35, buttonY + 30, "RUN");
+  Brain.Screen.setFillColor(color::orange);
+  Brain.Screen.drawRectangle(saveButtonX, buttonY, buttonWidth, buttonHeight);
+  Brain.Screen.printAt(saveButtonX + 30, buttonY + 30, "SAVE");
+  Brain.Screen.setFillColor(color::black);
+}
+
+/// @brief Interactive tuning of the turn and drive presets (see 1091A_TuningConsole.h for the buttons).
+/// @brief Runs until B is held, then hands the robot back to driver control
+void tuning_console() {
+  tuningConsoleActive = true;
+  DriverInput input;
+  TuningResult result;
+  int preset = TURN_PRESET_MEDIUM;
+  int field = 1;
+  float stepScale = 1.0;
+  bool outbound = true;
+  bool redraw = true;
+  bool wasTouching = false;
+  const char* status = "";
+
+  while (true) {
+    input.sample(Controller1);
+    bool run = input.A.pressed;
+    bool save = input.Y.pressed;
+
+    //Brain touchscreen: a value row picks the value, the buttons run and save
+    bool touching = Brain.Screen.pressing();
+    if (touching && !wasTouching) {
+      int x = Brain.Screen.xPosition();
+      int y = Brain.Screen.yPosition();
+      for (int ii = 0; ii < fieldCount(preset); ii++) {
+        if (touchInside(x, y, 0, tuningRowTop + tuningRowHeight*ii + 5, tuningResultX, tuningRowHeight)) { field = ii; redraw = true; }
+      }
+      if (touchInside(x, y, runButtonX, buttonY, buttonWidth, buttonHeight)) run = true;
+      if (touchInside(x, y, saveButtonX, buttonY, buttonWidth, buttonHeight)) save = true;
+    }
+    wasTouching = touching;
+
+    if (input.B.held(tuningExitHoldMSec)) break;
+
+    if (input.L1.pressed || input.L2.pressed) {
+      preset = (preset + (input.L1.pressed ? 1 : tuningPresetCount - 1)) % tuningPresetCount;
+      field = (field < fieldCount(preset)) ? field : 0;
+      result = TuningResult();
+      outbound = true;
+      status = "";
+      redraw = true;
+    }
+    if (input.Up.pressed) { field = (field + fieldCount(preset) - 1) % fieldCount(preset); redraw = true; }
+    if (input.Down.pressed) { field = (field + 1) % fieldCount(preset); redraw = true; }
+    if (input.R1.pressed && stepScale < 100) { stepScale *= 10; redraw = true; }
+    if (input.R2.pressed && stepScale > 0.01) { stepScale /= 10; redraw = true; }
+
+    bool raise = repeatPressed(input.Right, input.tickMSec);
+    bool lower = repeatPressed(input.Left, input.tickMSec);
+    if (raise != lower) {
+      float* value = fieldValue(preset, field);
+      float previous = *value;
+      *value = fmax(0, previous + (raise ? 1 : -1)*fieldInfo(preset, field).step*stepScale);
+      if (!presetValid(preset)) *value = previous;  //Keep it in the range the compile-time checks allow
+      status = "";
+      redraw = true;
+    }
+
+    if (input.X.pressed) {
+      if (isTurnPreset(preset)) robotConfig.turnPresets[preset] = robotConfigDefaults.turnPresets[preset];
+      else robotConfig.drivePresets[preset - TURN_PRESET_COUNT] = robotConfigDefaults.drivePresets[preset - TURN_PRESET_COUNT];
+      status = "RESET";
+      redraw = true;
+    }
+
+    if (save) {
+      status = saveRobotConfig(ROBOT_CONFIG_FILE_NAME) ? "SAVED" : "SAVE FAILED";
+      redraw = true;
+    }
+
+    if (run) {
+      drawTuningScreen(preset, field, stepScale, result, "RUNNING...");
+      result = runTestMotion(preset, outbound);
+      outbound = !outbound;
+      input.sample(Controller1);  //Don't act on buttons pressed during the motion
+      status = outbound ? "next: out" : "next: back";
+      redraw = true;
+    }
+
+    if (redraw) {
+      drawTuningScreen(preset, field, stepScale, result, status);
+      redraw = false;
+    }
+
+    //Only changed lines go over the radio, from controllerFeedbackTask
+    controllerFeedback.setLine(0, "%s", presetName(preset));
+    controllerFeedback.setLine(1, "%s %.3f", fieldInfo(preset, field).label, *fieldValue(preset, field));
+    if (result.valid) controllerFeedback.setLine(2, "os%.1f st%.0f", result.overshoot, result.settleMSec);
+    else controllerFeedback.setLine(2, "A run Y save");
+
+    task::sleep(20);
+  }
+
+  controllerFeedback.clear();
+  Brain.Screen.clearScreen();
+  tuningConsoleActive = false;
+}
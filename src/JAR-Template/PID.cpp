@@ -129,6 +129,9 @@ float PID::compute(float error){
  */
 
 bool PID::is_settled(){
+  // compute() has not run yet, so the clock for the timeout has not started
+  if (setTime < 0.0) return(false);
+
   // If timeout does equal 0, the move will never actually time out. Setting timeout to 0 is the equivalent of setting it to infinity
   // Otherwise check if we have spent enough time running the PID
   if (timeout != 0 && (((Brain.Timer.value() - setTime)*1000.0) >= timeout)) return(true);
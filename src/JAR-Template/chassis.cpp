@@ -0,0 +1,60 @@
+#include "vex.h"
+
+/**
+ * Rotation sensor tracking wheel.
+ *
+ * @param port Rotation sensor port, in "PORT1" format.
+ * @param diameter Wheel diameter in inches (reverse it to make the direction switch).
+ * @param center_distance Distance in inches from the tracking center (see main.cpp).
+ */
+
+RotationTracker::RotationTracker(int port, float diameter, float center_distance) :
+  sensor(port),
+  in_to_deg_ratio(M_PI*diameter/360.0),
+  center_distance(center_distance)
+{}
+
+/**
+ * Three wire encoder tracking wheel.
+ *
+ * @param port Triport, with Triport A as 1, Triport B as 2, and so on.
+ * @param diameter Wheel diameter in inches (reverse it to make the direction switch).
+ * @param center_distance Distance in inches from the tracking center (see main.cpp).
+ */
+
+EncoderTracker::EncoderTracker(int port, float diameter, float center_distance) :
+  sensor(ThreeWire.Port[to_port(port)]),
+  in_to_deg_ratio(M_PI*diameter/360.0),
+  center_distance(center_distance)
+{}
+
+/**
+ * Drive side tracking wheel.
+ *
+ * @param motors Motor group of one side of the drive.
+ * @param wheel_diameter Drive wheel diameter in inches.
+ * @param wheel_ratio External drive gear ratio.
+ * @param center_distance Distance in inches from the center to this side of the drive.
+ */
+
+MotorTracker::MotorTracker(vex::motor_group motors, float wheel_diameter, float wheel_ratio, float center_distance) :
+  motors(motors),
+  in_to_deg_ratio(M_PI*wheel_diameter*wheel_ratio/360.0),
+  center_distance(center_distance)
+{}
+
+/**
+ * Holonomic corner motors. A negative port reverses the motor.
+ *
+ * @param DriveLF_port Left front port.
+ * @param DriveRF_port Right front port.
+ * @param DriveLB_port Left back port.
+ * @param DriveRB_port Right back port.
+ */
+
+HolonomicMotors::HolonomicMotors(int DriveLF_port, int DriveRF_port, int DriveLB_port, int DriveRB_port) :
+  DriveLF(abs(DriveLF_port), is_reversed(DriveLF_port)),
+  DriveRF(abs(DriveRF_port), is_reversed(DriveRF_port)),
+  DriveLB(abs(DriveLB_port), is_reversed(DriveLB_port)),
+  DriveRB(abs(DriveRB_port), is_reversed(DriveRB_port))
+{}
@@ -2,65 +2,41 @@
 
 /**
  * Drive constructor for the chassis.
- * Even though there's only one constructor, there can be
- * huge differences in implementation depending on the drive style
- * selected.
+ * What the robot tracks with is decided by the odom_source, built in
+ * main.cpp from the tracker types the robot has, so the Drive itself
+ * never constructs a sensor it doesn't use.
  * 
- * @param drive_setup The style of drive, such as TANK_TWO_ROTATION.
  * @param DriveL Left motor group.
  * @param DriveR Right motor group.
  * @param gyro_port IMU port.
  * @param wheel_diameter Wheel diameter in inches.
  * @param wheel_ratio External drive gear ratio.
  * @param gyro_scale Scale factor in degrees.
- * @param DriveLF_port Left front port for holonomic drives.
- * @param DriveRF_port Right front port for holonomic drives.
- * @param DriveLB_port Left back port for holonomic drives.
- * @param DriveRB_port Right back port for holonomic drives.
- * @param ForwardTracker_port Port for the forward tracker.
- * @param ForwardTracker_diameter Diameter in inches.
- * @param ForwardTracker_center_distance Horizontal distance in inches.
- * @param SidewaysTracker_port Port for the sideways tracker.
- * @param SidewaysTracker_diameter Diameter in inches.
- * @param SidewaysTracker_center_distance Vertical distance in inches.
- */
-
-Drive::Drive(enum::drive_setup drive_setup, motor_group DriveL, motor_group DriveR, 
+ * @param odom_source Tracking wheels (a TrackerOdom).
+ * @param holonomic_motors Corner motors, for holonomic drives only.
+ */
+
+Drive::Drive(motor_group DriveL, motor_group DriveR, 
 int gyro_port, float wheel_diameter, float wheel_ratio, float gyro_scale, 
-int DriveLF_port, int DriveRF_port, int DriveLB_port, int DriveRB_port, 
-int ForwardTracker_port, float ForwardTracker_diameter, float ForwardTracker_center_distance, 
-int SidewaysTracker_port, float SidewaysTracker_diameter, float SidewaysTracker_center_distance) :
+OdomSource &odom_source) :
   wheel_diameter(wheel_diameter),
   wheel_ratio(wheel_ratio),
   gyro_scale(gyro_scale),
   drive_in_to_deg_ratio(M_PI*wheel_diameter*wheel_ratio/360.0),
-  ForwardTracker_center_distance(ForwardTracker_center_distance),
-  ForwardTracker_diameter(ForwardTracker_diameter),
-  ForwardTracker_in_to_deg_ratio(M_PI*ForwardTracker_diameter/360.0),
-  SidewaysTracker_center_distance(SidewaysTracker_center_distance),
-  SidewaysTracker_diameter(SidewaysTracker_diameter),
-  SidewaysTracker_in_to_deg_ratio(M_PI*SidewaysTracker_diameter/360.0),
-  drive_setup(drive_setup),
+  odom_source(odom_source),
   DriveL(DriveL),
   DriveR(DriveR),
-  Gyro(inertial(gyro_port)),
-  DriveLF(abs(DriveLF_port), is_reversed(DriveLF_port)),
-  DriveRF(abs(DriveRF_port), is_reversed(DriveRF_port)),
-  DriveLB(abs(DriveLB_port), is_reversed(DriveLB_port)),
-  DriveRB(abs(DriveRB_port), is_reversed(DriveRB_port)),
-  R_ForwardTracker(ForwardTracker_port),
-  R_SidewaysTracker(SidewaysTracker_port),
-  E_ForwardTracker(ThreeWire.Port[to_port(ForwardTracker_port)]),
-  E_SidewaysTracker(ThreeWire.Port[to_port(SidewaysTracker_port)])
+  Gyro(inertial(gyro_port))
 {
-    if (drive_setup == TANK_ONE_FORWARD_ENCODER || drive_setup == TANK_ONE_FORWARD_ROTATION || drive_setup == ZERO_TRACKER_ODOM){
-      odom.set_physical_distances(ForwardTracker_center_distance, 0);
-    } 
-    if (drive_setup == TANK_ONE_SIDEWAYS_ENCODER || drive_setup == TANK_ONE_SIDEWAYS_ROTATION || 
-    drive_setup == TANK_TWO_ENCODER || drive_setup == TANK_TWO_ROTATION ||
-    drive_setup == HOLONOMIC_TWO_ENCODER || drive_setup == HOLONOMIC_TWO_ROTATION){
-      odom.set_physical_distances(ForwardTracker_center_distance, SidewaysTracker_center_distance);
-    }
+  odom.set_physical_distances(odom_source.ForwardTracker_center_distance, odom_source.SidewaysTracker_center_distance);
+}
+
+Drive::Drive(motor_group DriveL, motor_group DriveR, 
+int gyro_port, float wheel_diameter, float wheel_ratio, float gyro_scale, 
+OdomSource &odom_source, HolonomicMotors &holonomic_motors) :
+  Drive(DriveL, DriveR, gyro_port, wheel_diameter, wheel_ratio, gyro_scale, odom_source)
+{
+  this->holonomic_motors = &holonomic_motors;
 }
 
 /**
@@ -75,6 +51,54 @@ void Drive::drive_with_voltage(float leftVoltage, float rightVoltage){
   DriveR.spin(fwd, rightVoltage,volt);
 }
 
+/**
+ * The side of the drive that speeds up to turn clockwise. Our left and
+ * right motor groups are mirrored, so it is DriveR. This and
+ * counterclockwise_side() are the only places that know it: every motion
+ * that works out its own wheel voltages (the MPC, the trajectory
+ * follower, swings) goes through them.
+ */
+
+motor_group& Drive::clockwise_side(){
+  return(DriveR);
+}
+
+/**
+ * The side of the drive that speeds up to turn counterclockwise (DriveL,
+ * see clockwise_side()).
+ */
+
+motor_group& Drive::counterclockwise_side(){
+  return(DriveL);
+}
+
+/**
+ * Drives each side of the chassis by which way it turns the robot. In
+ * the usual left/right wheel math (left = forward + clockwise turn) the
+ * left wheel is the clockwise side.
+ * 
+ * @param clockwise_side_voltage Voltage out of 12 for the side that turns the robot clockwise.
+ * @param counterclockwise_side_voltage Voltage out of 12 for the other side.
+ */
+
+void Drive::drive_with_side_voltages(float clockwise_side_voltage, float counterclockwise_side_voltage){
+  clockwise_side().spin(fwd, clockwise_side_voltage, volt);
+  counterclockwise_side().spin(fwd, counterclockwise_side_voltage, volt);
+}
+
+/**
+ * Drives with a forward voltage plus a turning voltage, scaled so neither
+ * side asks for more than 12 volts. A positive turn_voltage always turns
+ * clockwise (increasing heading).
+ * 
+ * @param drive_voltage Forward voltage out of 12.
+ * @param turn_voltage Clockwise turning voltage out of 12.
+ */
+
+void Drive::drive_with_turn_voltage(float drive_voltage, float turn_voltage){
+  drive_with_side_voltages(left_voltage_scaling(drive_voltage, turn_voltage), right_voltage_scaling(drive_voltage, turn_voltage));
+}
+
 /**
  * Resets default turn constants.
  * Turning includes turn_to_angle() and turn_to_point().
@@ -135,10 +159,77 @@ void Drive::set_heading_constants(float heading_max_voltage, float heading_kp, f
   this->heading_starti = heading_starti;
 }
 
+/**
+ * Sets the motion profile and precision phase of turn_to_angle().
+ * 
+ * @param turn_max_rate Cruise turn rate in deg/s (also capped by turn_max_voltage*heading_rate_per_volt).
+ * @param turn_max_accel Turn acceleration and deceleration in deg/s^2.
+ * @param turn_precision_window Error in degrees where the precision phase takes over.
+ * @param turn_precision_min_voltage Least voltage the precision phase pushes with.
+ */
+
+void Drive::set_turn_profile_constants(float turn_max_rate, float turn_max_accel, float turn_precision_window, float turn_precision_min_voltage){
+  this->turn_max_rate = turn_max_rate;
+  this->turn_max_accel = turn_max_accel;
+  this->turn_precision_window = turn_precision_window;
+  this->turn_precision_min_voltage = turn_precision_min_voltage;
+}
+
+/**
+ * Sets the inner (yaw rate) loop of the straight-drive heading hold.
+ * The heading PID output is treated as the turn voltage we want, and
+ * that voltage times heading_rate_per_volt is the turn rate it should
+ * give. The inner loop adds heading_rate_kp volts for every deg/s the
+ * gyro is off from that rate, which damps the outer loop and fights
+ * bumps before they show up as heading error.
+ * 
+ * @param heading_rate_per_volt Turn rate in deg/s per volt of turn (free spinning).
+ * @param heading_rate_kp Volts per deg/s of yaw rate error. Zero turns the inner loop off.
+ */
+
+void Drive::set_heading_rate_constants(float heading_rate_per_volt, float heading_rate_kp){
+  this->heading_rate_per_volt = heading_rate_per_volt;
+  this->heading_rate_kp = heading_rate_kp;
+}
+
+/**
+ * Sets the drive model used by the MPC odom moves (and anything else that
+ * needs to know what the chassis can physically do).
+ * 
+ * @param max_wheel_speed Wheel surface speed at 12 volts in in/s.
+ * @param max_wheel_accel Largest wheel acceleration in in/s^2 before slipping or browning out.
+ * @param track_width Distance between the left and right wheels in inches.
+ * @param wheel_accel_voltage Extra volts per in/s^2 of wheel acceleration (feedforward).
+ */
+
+void Drive::set_drive_model_constants(float max_wheel_speed, float max_wheel_accel, float track_width, float wheel_accel_voltage){
+  this->max_wheel_speed = max_wheel_speed;
+  this->max_wheel_accel = max_wheel_accel;
+  this->track_width = track_width;
+  this->wheel_accel_voltage = wheel_accel_voltage;
+  mpc.set_model(max_wheel_speed, max_wheel_accel, track_width);
+}
+
+/**
+ * Sets the limits and follower gains for trajectories. The wheel limits
+ * and track width come from set_drive_model_constants().
+ * 
+ * @param max_centripetal_accel Sideways acceleration in in/s^2 the robot can take on a curve without sliding. 0 for no limit.
+ * @param ramsete_beta How hard the follower pulls back onto the path (1/in^2). 2/m^2 is 0.0013/in^2.
+ * @param ramsete_zeta Damping of the follower, between 0 and 1.
+ */
+
+void Drive::set_trajectory_constants(float max_centripetal_accel, float ramsete_beta, float ramsete_zeta){
+  this->max_centripetal_accel = max_centripetal_accel;
+  this->ramsete_beta = ramsete_beta;
+  this->ramsete_zeta = ramsete_zeta;
+}
+
 /**
  * Resets default swing constants.
- * Swing control holds one side of the drive still and turns with the other.
- * Only left_swing_to_angle() and right_swing_to_angle() use these constants.
+ * Swing control turns by driving one side of the drive around the other.
+ * left_swing_to_angle(), right_swing_to_angle() and swing_arc_to_angle()
+ * use these constants.
  * 
  * @param swing_max_voltage Max voltage out of 12.
  * @param swing_kp Proportional constant.
@@ -187,6 +278,18 @@ void Drive::set_drive_exit_conditions(float drive_settle_error, float drive_sett
   this->drive_timeout = drive_timeout;
 }
 
+/**
+ * Sets the motion profile of the swings and swing arcs.
+ * 
+ * @param swing_max_rate Cruise turn rate in deg/s (also capped by swing_max_voltage*heading_rate_per_volt).
+ * @param swing_max_accel Turn acceleration and deceleration in deg/s^2.
+ */
+
+void Drive::set_swing_profile_constants(float swing_max_rate, float swing_max_accel){
+  this->swing_max_rate = swing_max_rate;
+  this->swing_max_accel = swing_max_accel;
+}
+
 /**
  * Resets default swing exit conditions.
  * The robot exits when error is less than settle_error for a duration of settle_time, 
@@ -203,6 +306,93 @@ void Drive::set_swing_exit_conditions(float swing_settle_error, float swing_sett
   this->swing_timeout = swing_timeout;
 }
 
+/**
+ * Resets driver control constants.
+ * The turn scale multiplies the turn stick after the deadband and curve,
+ * which lets a tall robot turn harder than the stick alone would.
+ * 
+ * @param driver_deadband Stick values smaller than this are zeroed.
+ * @param driver_turn_scale Multiplier on the turn stick.
+ */
+
+void Drive::set_driver_constants(float driver_deadband, float driver_turn_scale){
+  this->driver_deadband = driver_deadband;
+  this->driver_turn_scale = driver_turn_scale;
+}
+
+/**
+ * Resets driver control stick curves.
+ * Curves give finer control near the middle of the stick while
+ * still reaching full output at the end of the stick.
+ * 
+ * @param throttle_curve LINEAR_CURVE, EXPONENTIAL_CURVE or CUBIC_CURVE for the throttle stick.
+ * @param throttle_curve_gain Exponential gain, or cubic weight from 0 to 1.
+ * @param turn_curve LINEAR_CURVE, EXPONENTIAL_CURVE or CUBIC_CURVE for the turn stick.
+ * @param turn_curve_gain Exponential gain, or cubic weight from 0 to 1.
+ */
+
+void Drive::set_driver_curves(driver_curve throttle_curve, float throttle_curve_gain, driver_curve turn_curve, float turn_curve_gain){
+  this->throttle_curve = throttle_curve;
+  this->throttle_curve_gain = throttle_curve_gain;
+  this->turn_curve = turn_curve;
+  this->turn_curve_gain = turn_curve_gain;
+}
+
+/**
+ * Resets driver control heading hold constants.
+ * Heading hold only runs when heading_hold_enabled is set. It locks the
+ * heading when the turn stick is let go while driving, and corrects
+ * toward it with a PD loop. The latency is how far ahead the heading is
+ * predicted, to make up for the time between reading the gyro and the
+ * motors responding.
+ * 
+ * @param heading_hold_max_voltage Max correction voltage out of 12.
+ * @param heading_hold_kp Proportional constant.
+ * @param heading_hold_kd Derivative constant.
+ * @param heading_hold_latency Heading prediction time in milliseconds.
+ */
+
+void Drive::set_heading_hold_constants(float heading_hold_max_voltage, float heading_hold_kp, float heading_hold_kd, float heading_hold_latency){
+  this->heading_hold_max_voltage = heading_hold_max_voltage;
+  this->heading_hold_kp = heading_hold_kp;
+  this->heading_hold_kd = heading_hold_kd;
+  this->heading_hold_latency = heading_hold_latency;
+}
+
+/**
+ * The drive's current constants as a parameter set, for motions that
+ * change a few of them with the with_*() builders.
+ * 
+ * @return Drive, heading, exit and boomerang constants.
+ */
+
+drive_params Drive::default_drive_params(){
+  drive_params params = {drive_max_voltage, drive_min_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, {drive_kp, drive_ki, drive_kd, drive_starti}, {heading_kp, heading_ki, heading_kd, heading_starti}, boomerang_lead, boomerang_setback};
+  return(params);
+}
+
+/**
+ * The drive's current turn constants as a parameter set.
+ * 
+ * @return Turn and turn exit constants.
+ */
+
+turn_params Drive::default_turn_params(){
+  turn_params params = {turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, {turn_kp, turn_ki, turn_kd, turn_starti}};
+  return(params);
+}
+
+/**
+ * The drive's current swing constants as a parameter set.
+ * 
+ * @return Swing and swing exit constants.
+ */
+
+turn_params Drive::default_swing_params(){
+  turn_params params = {swing_max_voltage, swing_settle_error, swing_settle_time, swing_timeout, {swing_kp, swing_ki, swing_kd, swing_starti}};
+  return(params);
+}
+
 /**
  * Gives the drive's absolute heading with Gyro correction.
  * 
@@ -213,6 +403,53 @@ float Drive::get_absolute_heading(){
   return( reduce_0_to_360( Gyro.rotation()*360.0/gyro_scale) ); 
 }
 
+/**
+ * Yaw rate from the change in Gyro.rotation() between calls, scaled the
+ * same way as the heading. It is worked out from the same reading as
+ * get_absolute_heading(), so it is positive clockwise by construction
+ * and the yaw rate loops can't end up with the wrong sign. The IMU
+ * sends new data every 10 msec, so the rate is only recomputed once at
+ * least that long has passed, and a gap over 100 msec (no motion was
+ * asking) starts again from 0.
+ * 
+ * @return Clockwise turn rate in deg/s.
+ */
+
+float Drive::get_heading_rate(){
+  double now = Brain.Timer.value()*1000.0;
+  float rotation = Gyro.rotation();
+  double elapsed = now - heading_rate_prev_time;
+  if (heading_rate_prev_time < 0 || elapsed > 100) {
+    heading_rate = 0;
+  } else if (elapsed >= 10) {
+    heading_rate = (rotation - heading_rate_prev_rotation)*1000.0/elapsed*360.0/gyro_scale;
+  } else {
+    return(heading_rate);
+  }
+  heading_rate_prev_rotation = rotation;
+  heading_rate_prev_time = now;
+  return(heading_rate);
+}
+
+/**
+ * One step of the cascaded heading hold used by the straight drives.
+ * The outer PID turns heading error into the turn voltage we want, and
+ * the inner loop corrects that voltage by how far the measured yaw rate
+ * is from the rate it should produce.
+ * 
+ * @param headingPID Outer loop PID, created at the start of the drive.
+ * @param heading Heading to hold.
+ * @param heading_max_voltage Max turn voltage out of 12.
+ * @return Clockwise turn voltage.
+ */
+
+float Drive::straight_heading_correction(PID& headingPID, float heading, float heading_max_voltage){
+  float heading_error = reduce_negative_180_to_180(heading - get_absolute_heading());
+  float heading_output = clamp(headingPID.compute(heading_error), -heading_max_voltage, heading_max_voltage);
+  float rate_error = heading_output*heading_rate_per_volt - get_heading_rate();
+  return( clamp(heading_output + heading_rate_kp*rate_error, -heading_max_voltage, heading_max_voltage) );
+}
+
 /**
  * Gets the motor group's position and converts to inches.
  * 
@@ -244,36 +481,210 @@ void Drive::drive_stop(vex::brakeType mode){
   DriveR.stop(mode);
 }
 
+/**
+ * Contact terminators. Each one is armed for the next motion only
+ * (any Drive motion, or drive_until_contact()) and ends it early the
+ * moment the robot hits something, instead of waiting out a fixed time
+ * or a slow, careful approach. After the motion, terminated_on_contact
+ * says whether a terminator ended it.
+ * 
+ * Ends the motion when the drive motors slow below stall_velocity
+ * for stall_time. Ignored for the first terminator_grace_time of
+ * the motion while the drive spins up.
+ * 
+ * @param stall_velocity Average drive motor speed in percent.
+ * @param stall_time Time in ms the drive has to stay below stall_velocity.
+ */
+
+void Drive::stop_on_stall(float stall_velocity, float stall_time){
+  this->stall_velocity = stall_velocity;
+  this->stall_time = stall_time;
+  stall_terminator_armed = true;
+}
+
+/**
+ * Ends the motion when the drive motors pull more than current_limit
+ * each for current_time. Also ignored during terminator_grace_time,
+ * since starting from rest draws a current spike too.
+ * 
+ * @param current_limit Average current per drive motor in amps.
+ * @param current_time Time in ms the current has to stay above current_limit.
+ */
+
+void Drive::stop_on_current(float current_limit, float current_time){
+  this->current_limit = current_limit;
+  this->current_time = current_time;
+  current_terminator_armed = true;
+}
+
+/**
+ * Ends the motion as soon as the distance sensor reads distance_mm
+ * or closer.
+ * 
+ * @param sensor Distance sensor facing the way we are driving.
+ * @param distance_mm Reading in mm that counts as contact.
+ */
+
+void Drive::stop_on_distance(vex::distance &sensor, float distance_mm){
+  distance_terminator_sensor = &sensor;
+  distance_terminator_mm = distance_mm;
+}
+
+/**
+ * Checks the armed terminators. Motion loops call this once per loop.
+ * 
+ * @return Whether a terminator has fired and the motion should stop.
+ */
+
+bool Drive::motion_terminated(){
+  double now = Brain.Timer.value()*1000.0;
+  if (terminator_motion_start < 0) {
+    terminator_motion_start = now;
+    terminated_on_contact = false;
+  }
+  bool past_grace_time = now - terminator_motion_start >= terminator_grace_time;
+
+  if (distance_terminator_sensor != NULL && distance_terminator_sensor->objectDistance(mm) <= distance_terminator_mm) {
+    terminated_on_contact = true;
+  }
+
+  if (stall_terminator_armed && past_grace_time) {
+    float speed = (fabs(DriveL.velocity(percent)) + fabs(DriveR.velocity(percent)))/2.0;
+    if (speed > stall_velocity) { stall_started = -1; }
+    else if (stall_started < 0) { stall_started = now; }
+    if (stall_started >= 0 && now - stall_started >= stall_time) { terminated_on_contact = true; }
+  }
+
+  if (current_terminator_armed && past_grace_time) {
+    float current = (DriveL.current(amp) + DriveR.current(amp))/(DriveL.count() + DriveR.count());
+    if (current < current_limit) { current_started = -1; }
+    else if (current_started < 0) { current_started = now; }
+    if (current_started >= 0 && now - current_started >= current_time) { terminated_on_contact = true; }
+  }
+
+  return(terminated_on_contact);
+}
+
+/**
+ * Disarms every terminator. Motions call this when they finish, which
+ * is what makes the terminators one-shot. terminated_on_contact is kept
+ * until the next motion starts.
+ */
+
+void Drive::clear_terminators(){
+  stall_terminator_armed = false;
+  current_terminator_armed = false;
+  distance_terminator_sensor = NULL;
+  terminator_motion_start = -1;
+  stall_started = -1;
+  current_started = -1;
+}
+
+/**
+ * Drives straight at a fixed voltage until a terminator fires or the
+ * timeout runs out, then brakes. If no terminator is armed, it stops
+ * on a stall (below 10% speed for 60 ms).
+ * 
+ * @param voltage Drive voltage out of 12; negative drives backwards.
+ * @param timeout Time in ms to give up after.
+ */
+
+void Drive::drive_until_contact(float voltage, float timeout){
+  if (!stall_terminator_armed && !current_terminator_armed && distance_terminator_sensor == NULL) {
+    stop_on_stall(10, 60);
+  }
+  double start_time = Brain.Timer.value()*1000.0;
+  drive_with_voltage(voltage, voltage);
+  while(!motion_terminated() && Brain.Timer.value()*1000.0 - start_time < timeout){
+    task::sleep(5);
+  }
+  drive_stop(brake);
+  clear_terminators();
+}
+
 /**
  * Turns the robot to a field-centric angle.
  * Optimizes direction, so it turns whichever way is closer to the 
  * current heading of the robot.
  * 
+ * This is the one turn engine; turn_to_point() and the 1091A turn
+ * presets all end up here. It never resets the gyro, so odom keeps a
+ * valid heading. The loop runs at a fixed turn_loop_period. The heading
+ * follows a trapezoidal profile (turn_max_rate, turn_max_accel), using
+ * feedforward from heading_rate_per_volt, the yaw rate loop and the turn
+ * PID on the distance from the profile. Once the profile is done, or the
+ * robot is within turn_precision_window, a precision phase takes over:
+ * a P loop that never pushes less than turn_precision_min_voltage, so
+ * the last degree is not left to friction.
+ * 
  * @param angle Desired angle in degrees.
  */
 
 void Drive::turn_to_angle(float angle){
-  turn_to_angle(angle, turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, turn_kp, turn_ki, turn_kd, turn_starti);
+  turn_to_angle(angle, default_turn_params());
 }
 
 void Drive::turn_to_angle(float angle, float turn_max_voltage){
-  turn_to_angle(angle, turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, turn_kp, turn_ki, turn_kd, turn_starti);
+  turn_to_angle(angle, default_turn_params().with_max_voltage(turn_max_voltage));
 }
 
 void Drive::turn_to_angle(float angle, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout){
-  turn_to_angle(angle, turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, turn_kp, turn_ki, turn_kd, turn_starti);
+  turn_to_angle(angle, default_turn_params().with_max_voltage(turn_max_voltage).with_exit(turn_settle_error, turn_settle_time, turn_timeout));
 }
 
 void Drive::turn_to_angle(float angle, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout, float turn_kp, float turn_ki, float turn_kd, float turn_starti){
-  PID turnPID(reduce_negative_180_to_180(angle - get_absolute_heading()), turn_kp, turn_ki, turn_kd, turn_starti, turn_settle_error, turn_settle_time, turn_timeout);
-  while( !turnPID.is_settled() ){
-    float error = reduce_negative_180_to_180(angle - get_absolute_heading());
-    float output = turnPID.compute(error);
-    output = clamp(output, -turn_max_voltage, turn_max_voltage);
-    drive_with_voltage(output, -output);
-    task::sleep(10);
+  turn_params params = {turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, {turn_kp, turn_ki, turn_kd, turn_starti}};
+  turn_to_angle(angle, params);
+}
+
+void Drive::turn_to_angle(float angle, const turn_params &params){
+  float start_heading = get_absolute_heading();
+  float turn_distance = reduce_negative_180_to_180(angle - start_heading);
+  float max_rate = turn_max_rate;
+  if (heading_rate_per_volt > 0) { max_rate = fmin(max_rate, params.max_voltage*heading_rate_per_volt); }
+
+  PID turnPID(turn_distance, params.gains.kp, params.gains.ki, params.gains.kd, params.gains.starti);
+  bool precision_phase = false;
+  float time_settled = 0;
+  double start_time = Brain.Timer.value()*1000.0;
+  double next_loop_time = start_time;
+
+  while(true){
+    if (motion_terminated()) { break; }
+    double now = Brain.Timer.value()*1000.0;
+    float heading = get_absolute_heading();
+    float final_error = reduce_negative_180_to_180(angle - heading);
+
+    if (fabs(final_error) < params.settle_error) { time_settled += turn_loop_period; }
+    else { time_settled = 0; }
+    if (time_settled >= params.settle_time) { break; }
+    if (params.timeout != 0 && now - start_time >= params.timeout) { break; }
+
+    float profile_position, profile_rate;
+    bool profile_done = trapezoidal_profile(turn_distance, max_rate, turn_max_accel, (now - start_time)/1000.0, profile_position, profile_rate);
+    if (profile_done || fabs(final_error) < turn_precision_window) { precision_phase = true; }
+
+    float output;
+    if (precision_phase) {
+      output = params.gains.kp*final_error;
+      if (fabs(final_error) < params.settle_error) { output = 0; }
+      else if (fabs(output) < turn_precision_min_voltage) { output = final_error > 0 ? turn_precision_min_voltage : -turn_precision_min_voltage; }
+    } else {
+      float tracking_error = reduce_negative_180_to_180(start_heading + profile_position - heading);
+      float feedforward = heading_rate_per_volt > 0 ? profile_rate/heading_rate_per_volt : 0;
+      output = feedforward + turnPID.compute(tracking_error) + heading_rate_kp*(profile_rate - get_heading_rate());
+    }
+    output = clamp(output, -params.max_voltage, params.max_voltage);
+    drive_with_turn_voltage(0, output);
+
+    //Sleep until the next loop time so the loop runs at a fixed rate no matter how long the math took
+    next_loop_time += turn_loop_period;
+    now = Brain.Timer.value()*1000.0;
+    if (next_loop_time > now) { task::sleep(static_cast<uint32_t>(next_loop_time - now)); }
+    else { next_loop_time = now; }
   }
   drive_stop(hold);
+  clear_terminators();
 }
 
 /**
@@ -289,131 +700,348 @@ void Drive::turn_to_angle(float angle, float turn_max_voltage, float turn_settle
  */
 
 void Drive::drive_distance(float distance){
-  drive_distance(distance, get_absolute_heading(), drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_distance(distance, get_absolute_heading(), default_drive_params());
 }
 
 void Drive::drive_distance(float distance, float heading){
-  drive_distance(distance, heading, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_distance(distance, heading, default_drive_params());
 }
 
 void Drive::drive_distance(float distance, float heading, float drive_max_voltage, float heading_max_voltage){
-  drive_distance(distance, heading, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_distance(distance, heading, default_drive_params().with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage));
 }
 
 void Drive::drive_distance(float distance, float heading, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout){
-  drive_distance(distance, heading, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_distance(distance, heading, default_drive_params().with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage).with_exit(drive_settle_error, drive_settle_time, drive_timeout));
 }
 
-void Drive::drive_distance(float distance, float heading, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti) {
-  PID drivePID(distance, drive_kp, drive_ki, drive_kd, drive_starti, drive_settle_error, drive_settle_time, drive_timeout);
-  //PID headingPID(reduce_negative_180_to_180(heading - get_absolute_heading()), heading_kp, heading_ki, heading_kd, heading_starti);
-  float start_average_position = ForwardTracker_diameter*M_PI*R_ForwardTracker.position(degrees)/360.0; //(get_left_position_in()+get_right_position_in())/2.0;
+void Drive::drive_distance(float distance, float heading, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti){
+  drive_params params = {drive_max_voltage, drive_min_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, {drive_kp, drive_ki, drive_kd, drive_starti}, {heading_kp, heading_ki, heading_kd, heading_starti}, boomerang_lead, boomerang_setback};
+  drive_distance(distance, heading, params);
+}
+
+void Drive::drive_distance(float distance, float heading, const drive_params &params){
+  PID drivePID(distance, params.drive.kp, params.drive.ki, params.drive.kd, params.drive.starti, params.settle_error, params.settle_time, params.timeout);
+  PID headingPID(reduce_negative_180_to_180(heading - get_absolute_heading()), params.heading.kp, params.heading.ki, params.heading.kd, params.heading.starti);
+  float start_average_position = get_ForwardTracker_position(); //(get_left_position_in()+get_right_position_in())/2.0;
   float average_position = start_average_position;
   float drive_error = distance;
 
-  while((fabs(drive_error) >= fabs(drive_settle_error)) || !drivePID.is_settled()){
-    average_position = ForwardTracker_diameter*M_PI*R_ForwardTracker.position(degrees)/360.0; //(get_left_position_in()+get_right_position_in())/2.0;
+  while((fabs(drive_error) >= fabs(params.settle_error)) || !drivePID.is_settled()){
+    if (motion_terminated()) { break; }
+    average_position = get_ForwardTracker_position(); //(get_left_position_in()+get_right_position_in())/2.0;
     drive_error = distance+start_average_position-average_position;
-    //float heading_error = reduce_negative_180_to_180(heading - get_absolute_heading());
     float drive_output = drivePID.compute(drive_error);
-    float heading_output = 0.0; //headingPID.compute(heading_error);
+    float heading_output = straight_heading_correction(headingPID, heading, params.heading_max_voltage);
 
-    drive_output = clamp(drive_output, -drive_max_voltage, drive_max_voltage);
-    //heading_output = clamp(heading_output, -heading_max_voltage, heading_max_voltage);
+    drive_output = clamp(drive_output, -params.max_voltage, params.max_voltage);
 
     //If the newly calculated drivevolts is less than 2.5, then make it 2.5 (while maintaining the +ve/-ve sign)
     if((drive_output >= 0.0) && (drive_output < 2.5)) drive_output = 2.5;
     else if((drive_output < 0.0) && (drive_output > -2.5)) drive_output = -2.5;
 
-    drive_with_voltage(drive_output+heading_output, drive_output-heading_output);
+    drive_with_turn_voltage(drive_output, heading_output);
     task::sleep(5); //was 10
   }
   drive_stop(hold);
   task::sleep(10);
+  clear_terminators();
 }
 
 /**
  * Turns to a given angle with only one side of the drivetrain.
  * Like turn_to_angle(), is optimized for turning the shorter
- * direction.
+ * direction. Only the left side moves, while the right side holds its
+ * place. It drives forward when it is the side that turns the robot
+ * the way it needs to go (clockwise_side() for a clockwise swing,
+ * counterclockwise_side() for a counterclockwise one) and backward
+ * otherwise. right_swing_to_angle() is the same with the right side.
+ * Runs on the swing arc engine (see swing_arc_to_angle()).
  * 
  * @param angle Desired angle in degrees.
  */
 
 void Drive::left_swing_to_angle(float angle){
-  left_swing_to_angle(angle, swing_max_voltage, swing_settle_error, swing_settle_time, swing_timeout, swing_kp, swing_ki, swing_kd, swing_starti);
+  left_swing_to_angle(angle, default_swing_params());
 }
 
 void Drive::left_swing_to_angle(float angle, float swing_max_voltage, float swing_settle_error, float swing_settle_time, float swing_timeout, float swing_kp, float swing_ki, float swing_kd, float swing_starti){
-  PID swingPID(reduce_negative_180_to_180(angle - get_absolute_heading()), swing_kp, swing_ki, swing_kd, swing_starti, swing_settle_error, swing_settle_time, swing_timeout);
-  while(swingPID.is_settled() == false){
-    float error = reduce_negative_180_to_180(angle - get_absolute_heading());
-    float output = swingPID.compute(error);
-    output = clamp(output, -turn_max_voltage, turn_max_voltage);
-    DriveL.spin(fwd, output, volt);
-    DriveR.stop(hold);
-    task::sleep(10);
-  }
+  turn_params params = {swing_max_voltage, swing_settle_error, swing_settle_time, swing_timeout, {swing_kp, swing_ki, swing_kd, swing_starti}};
+  left_swing_to_angle(angle, params);
+}
+
+void Drive::left_swing_to_angle(float angle, const turn_params &params){
+  // Only DriveL moves, so it drives forward when it is the side that turns the robot the way we want to go.
+  bool left_turns_clockwise = &clockwise_side() == &DriveL;
+  bool reversed = (reduce_negative_180_to_180(angle - get_absolute_heading()) > 0) != left_turns_clockwise;
+  swing_motion(angle, 0, reversed, 0, params);
 }
 
 void Drive::right_swing_to_angle(float angle){
-  right_swing_to_angle(angle, swing_max_voltage, swing_settle_error, swing_settle_time, swing_timeout, swing_kp, swing_ki, swing_kd, swing_starti);
+  right_swing_to_angle(angle, default_swing_params());
 }
 
 void Drive::right_swing_to_angle(float angle, float swing_max_voltage, float swing_settle_error, float swing_settle_time, float swing_timeout, float swing_kp, float swing_ki, float swing_kd, float swing_starti){
-  PID swingPID(reduce_negative_180_to_180(angle - get_absolute_heading()), swing_kp, swing_ki, swing_kd, swing_starti, swing_settle_error, swing_settle_time, swing_timeout);
-  while(swingPID.is_settled() == false){
-    float error = reduce_negative_180_to_180(angle - get_absolute_heading());
-    float output = swingPID.compute(error);
-    output = clamp(output, -turn_max_voltage, turn_max_voltage);
-    DriveR.spin(reverse, output, volt);
-    DriveL.stop(hold);
-    task::sleep(10);
+  turn_params params = {swing_max_voltage, swing_settle_error, swing_settle_time, swing_timeout, {swing_kp, swing_ki, swing_kd, swing_starti}};
+  right_swing_to_angle(angle, params);
+}
+
+void Drive::right_swing_to_angle(float angle, const turn_params &params){
+  // Only DriveR moves, so it drives forward when it is the side that turns the robot the way we want to go.
+  bool right_turns_clockwise = &clockwise_side() == &DriveR;
+  bool reversed = (reduce_negative_180_to_180(angle - get_absolute_heading()) > 0) != right_turns_clockwise;
+  swing_motion(angle, 0, reversed, 0, params);
+}
+
+/**
+ * Drives an arc of a given radius until the robot faces a given angle.
+ * The radius is from the center of the robot, so 0 turns in place,
+ * track_width/2 pivots on one side like the swings above, and anything
+ * bigger is a sweeping curve with both sides moving, which can pick up
+ * a game piece on the way instead of a turn and then a drive. Turns
+ * the shorter direction, driving forward unless reversed. Needs
+ * track_width (set_drive_model_constants()).
+ * 
+ * With a swing_exit_error, the motion ends as soon as the heading is
+ * that close, without stopping the drive, so the next motion picks up
+ * at speed. Leave it at 0 to settle and hold.
+ * 
+ * @param angle Desired angle in degrees.
+ * @param radius Turning radius of the robot's center in inches.
+ * @param reversed Drive the arc backward.
+ * @param swing_exit_error Heading error in degrees to hand over to the next motion at, or 0 to settle.
+ */
+
+void Drive::swing_arc_to_angle(float angle, float radius){
+  swing_arc_to_angle(angle, radius, false, 0, default_swing_params());
+}
+
+void Drive::swing_arc_to_angle(float angle, float radius, bool reversed){
+  swing_arc_to_angle(angle, radius, reversed, 0, default_swing_params());
+}
+
+void Drive::swing_arc_to_angle(float angle, float radius, bool reversed, float swing_exit_error){
+  swing_arc_to_angle(angle, radius, reversed, swing_exit_error, default_swing_params());
+}
+
+void Drive::swing_arc_to_angle(float angle, float radius, bool reversed, float swing_exit_error, float swing_max_voltage, float swing_settle_error, float swing_settle_time, float swing_timeout, float swing_kp, float swing_ki, float swing_kd, float swing_starti){
+  turn_params params = {swing_max_voltage, swing_settle_error, swing_settle_time, swing_timeout, {swing_kp, swing_ki, swing_kd, swing_starti}};
+  swing_arc_to_angle(angle, radius, reversed, swing_exit_error, params);
+}
+
+void Drive::swing_arc_to_angle(float angle, float radius, bool reversed, float swing_exit_error, const turn_params &params){
+  float half_track = track_width/2;
+  radius = fabs(radius);
+  // How far the inside wheel goes for each inch of the outside wheel: -1 in place, 0 pivoting, toward 1 on a wide arc.
+  float inner_ratio = (radius + half_track > 0) ? (radius - half_track)/(radius + half_track) : -1;
+  swing_motion(angle, inner_ratio, reversed, swing_exit_error, params);
+}
+
+/**
+ * The one swing loop. The outside wheel drives the turn and the inside
+ * wheel follows it at inner_ratio, closed on the wheel positions with
+ * drive_kp so the arc keeps its shape (at a ratio of 0 this holds the
+ * inside wheel in place). The heading follows a trapezoidal profile
+ * (swing_max_rate, swing_max_accel) with feedforward from
+ * heading_rate_per_volt, the yaw rate loop and the swing PID on the
+ * distance from the profile, like turn_to_angle(). Every term is scaled
+ * by how little the arc turns per volt, so the swing gains tuned on a
+ * one-sided swing hold at any radius. Runs at turn_loop_period.
+ * 
+ * @param angle Desired angle in degrees.
+ * @param inner_ratio Inside wheel travel over outside wheel travel.
+ * @param reversed Drive the arc backward.
+ * @param swing_exit_error Heading error in degrees to end at without stopping, or 0 to settle.
+ */
+
+void Drive::swing_motion(float angle, float inner_ratio, bool reversed, float swing_exit_error, const turn_params &params){
+  float start_heading = get_absolute_heading();
+  float turn_distance = reduce_negative_180_to_180(angle - start_heading);
+  float turn_direction = turn_distance < 0 ? -1 : 1;
+  float travel_direction = reversed ? -1 : 1;
+  // Driving forward, a clockwise arc has the clockwise side (see clockwise_side()) outside; backing up or turning
+  // counterclockwise swaps it.
+  bool outer_is_clockwise_side = (turn_direction > 0) != reversed;
+  motor_group &outer_side = outer_is_clockwise_side ? clockwise_side() : counterclockwise_side();
+  motor_group &inner_side = outer_is_clockwise_side ? counterclockwise_side() : clockwise_side();
+
+  // Outside wheel volts per volt of point-turn command: 2 when pivoting, 1 turning in place.
+  float outer_scale = 2/(1 - inner_ratio);
+  float max_rate = swing_max_rate;
+  if (heading_rate_per_volt > 0) { max_rate = fmin(max_rate, params.max_voltage*heading_rate_per_volt/outer_scale); }
+
+  PID swingPID(turn_distance, params.gains.kp, params.gains.ki, params.gains.kd, params.gains.starti);
+  float outer_start = outer_side.position(deg)*drive_in_to_deg_ratio;
+  float inner_start = inner_side.position(deg)*drive_in_to_deg_ratio;
+  bool chained = false;
+  float time_settled = 0;
+  double start_time = Brain.Timer.value()*1000.0;
+  double next_loop_time = start_time;
+
+  while(true){
+    if (motion_terminated()) { break; }
+    double now = Brain.Timer.value()*1000.0;
+    float heading = get_absolute_heading();
+    float final_error = reduce_negative_180_to_180(angle - heading);
+
+    if (swing_exit_error > 0 && final_error*turn_direction < swing_exit_error) {
+      chained = true;
+      break;
+    }
+    if (fabs(final_error) < params.settle_error) { time_settled += turn_loop_period; }
+    else { time_settled = 0; }
+    if (time_settled >= params.settle_time) { break; }
+    if (params.timeout != 0 && now - start_time >= params.timeout) { break; }
+
+    float profile_position, profile_rate;
+    trapezoidal_profile(turn_distance, max_rate, swing_max_accel, (now - start_time)/1000.0, profile_position, profile_rate);
+    float tracking_error = reduce_negative_180_to_180(start_heading + profile_position - heading);
+    float feedforward = heading_rate_per_volt > 0 ? profile_rate/heading_rate_per_volt : 0;
+    float turn_output = (feedforward + heading_rate_kp*(profile_rate - get_heading_rate()))*outer_scale + swingPID.compute(tracking_error)*outer_scale/2;
+
+    // Outside wheel volts along the direction of travel, then the inside wheel following it.
+    float outer_output = clamp(turn_output*turn_direction, -params.max_voltage, params.max_voltage)*travel_direction;
+    float outer_travel = outer_side.position(deg)*drive_in_to_deg_ratio - outer_start;
+    float inner_travel = inner_side.position(deg)*drive_in_to_deg_ratio - inner_start;
+    float inner_output = outer_output*inner_ratio + drive_kp*(outer_travel*inner_ratio - inner_travel);
+    inner_output = clamp(inner_output, -params.max_voltage, params.max_voltage);
+    if (outer_is_clockwise_side) { drive_with_side_voltages(outer_output, inner_output); }
+    else { drive_with_side_voltages(inner_output, outer_output); }
+
+    next_loop_time += turn_loop_period;
+    now = Brain.Timer.value()*1000.0;
+    if (next_loop_time > now) { task::sleep(static_cast<uint32_t>(next_loop_time - now)); }
+    else { next_loop_time = now; }
   }
+  if (!chained) { drive_stop(hold); }
+  clear_terminators();
 }
 
 /**
- * Depending on the drive style, gets the tracker's position.
+ * Gets the forward tracker's position from the odom source.
  * 
- * @return The tracker position.
+ * @return The tracker position in inches.
  */
 
 float Drive::get_ForwardTracker_position(){
-  if (drive_setup==ZERO_TRACKER_ODOM || drive_setup == TANK_ONE_SIDEWAYS_ENCODER || drive_setup == TANK_ONE_SIDEWAYS_ROTATION){
-    return(get_right_position_in());
-  }
-  if (drive_setup==TANK_ONE_FORWARD_ENCODER || drive_setup == TANK_TWO_ENCODER || drive_setup == HOLONOMIC_TWO_ENCODER){
-    return(E_ForwardTracker.position(deg)*ForwardTracker_in_to_deg_ratio);
-  }else{
-    return(R_ForwardTracker.position(deg)*ForwardTracker_in_to_deg_ratio);
-  }
+  return(odom_source.forward_position());
 }
 
 /**
- * Depending on the drive style, gets the tracker's position.
+ * Gets the sideways tracker's position from the odom source.
  * 
- * @return The tracker position.
+ * @return The tracker position in inches.
  */
 
 float Drive::get_SidewaysTracker_position(){
-  if (drive_setup==TANK_ONE_FORWARD_ENCODER || drive_setup == TANK_ONE_FORWARD_ROTATION || drive_setup == ZERO_TRACKER_ODOM){
-    return(0);
-  }else if (drive_setup == TANK_TWO_ENCODER || drive_setup == HOLONOMIC_TWO_ENCODER || drive_setup == TANK_ONE_SIDEWAYS_ENCODER){
-    return(E_SidewaysTracker.position(deg)*SidewaysTracker_in_to_deg_ratio);
-  }else{
-    return(R_SidewaysTracker.position(deg)*SidewaysTracker_in_to_deg_ratio);
-  }
+  return(odom_source.sideways_position());
 }
 
 /**
- * Background task for updating the odometry.
+ * Background task for updating the odometry. The loop lives in the
+ * odom source, built for its trackers.
  */
 
 void Drive::position_track(){
-  while(1){
-    odom.update_position(get_ForwardTracker_position(), get_SidewaysTracker_position(), get_absolute_heading());
-    task::sleep(5);
-  }
+  odom_source.track(*this);
+}
+
+/**
+ * Sets the field and gating constants for relocalize_from_wall().
+ * 
+ * @param field_half_width Distance in inches from the field center to the inside of each wall.
+ * @param relocalize_max_incidence Largest angle in degrees between the sensor beam and the wall normal to trust a reading.
+ * @param relocalize_max_correction Largest correction in inches to accept; bigger ones are something other than the wall.
+ */
+
+void Drive::set_relocalize_constants(float field_half_width, float relocalize_max_incidence, float relocalize_max_correction){
+  this->field_half_width = field_half_width;
+  this->relocalize_max_incidence = relocalize_max_incidence;
+  this->relocalize_max_correction = relocalize_max_correction;
+}
+
+/**
+ * Sets how many readings relocalize_from_wall() needs, and which parts
+ * of the walls it trusts.
+ * 
+ * @param relocalize_agreement Inches the corrections from consecutive readings may differ by and still agree.
+ * @param relocalize_agreeing_readings Agreeing readings in a row needed before odom is corrected.
+ * @param relocalize_stake_clearance Inches either side of each wall's center to ignore, where the stakes stand.
+ * @param relocalize_corner_clearance Inches from each corner to ignore, where mogos get pushed.
+ */
+
+void Drive::set_relocalize_filter_constants(float relocalize_agreement, int relocalize_agreeing_readings, float relocalize_stake_clearance, float relocalize_corner_clearance){
+  this->relocalize_agreement = relocalize_agreement;
+  this->relocalize_agreeing_readings = relocalize_agreeing_readings;
+  this->relocalize_stake_clearance = relocalize_stake_clearance;
+  this->relocalize_corner_clearance = relocalize_corner_clearance;
+}
+
+/**
+ * Corrects the odom position from a distance sensor pointed at a
+ * field wall. The heading picks which wall the beam hits and gives the
+ * beam's angle to it. The reading then fixes the robot's coordinate
+ * along that wall's normal (X for the side walls, Y for the end walls).
+ * The other coordinate and the heading are left alone. Odom is nudged
+ * in place by correction_gain of the error, so this can be called every
+ * loop while driving.
+ * Readings at a steep angle, out of range, or implying a jump bigger
+ * than relocalize_max_correction are ignored. So are beams that would
+ * hit the wall where the field has something standing in front of it:
+ * the stakes in the middle of every wall, and the corners. Anything
+ * else in the way (a robot, a loose mogo) is caught by waiting for
+ * relocalize_agreeing_readings in a row that ask for the same
+ * correction, since a beam sweeping past an object doesn't.
+ * Odom has to be field-centric (origin at the field center) for this
+ * to make sense.
+ * 
+ * @param sensor Distance sensor to read.
+ * @param sensor_forward_offset Inches the sensor sits in front of the tracking center (negative is behind).
+ * @param sensor_sideways_offset Inches the sensor sits to the right of the tracking center (negative is left).
+ * @param sensor_faces_forward True if the sensor looks out the front of the robot, false if out the back.
+ * @param correction_gain Fraction of the error to correct this call, from 0 to 1.
+ * @param streak This sensor's recent readings, updated every call.
+ * @return Whether a correction was applied.
+ */
+
+bool Drive::relocalize_from_wall(vex::distance &sensor, float sensor_forward_offset, float sensor_sideways_offset, bool sensor_faces_forward, float correction_gain, wall_reading_streak &streak){
+  float reading_mm = sensor.objectDistance(mm);
+  if (reading_mm <= 20 || reading_mm >= 1500) { streak.count = 0; return(false); }
+  float reading_in = reading_mm/25.4;
+
+  float heading = to_rad(get_absolute_heading());
+  float beam_angle = sensor_faces_forward ? heading : heading + M_PI;
+  float beam_X = sin(beam_angle);
+  float beam_Y = cos(beam_angle);
+  // Sensor offset from the tracking center, in field coordinates (forward is (sin, cos), right is (cos, -sin)).
+  float offset_X = sensor_forward_offset*sin(heading) + sensor_sideways_offset*cos(heading);
+  float offset_Y = sensor_forward_offset*cos(heading) - sensor_sideways_offset*sin(heading);
+
+  bool hits_end_wall = fabs(beam_Y) >= fabs(beam_X);
+  float beam_along_normal = hits_end_wall ? beam_Y : beam_X;
+  if (to_deg(acos(fmin(fabs(beam_along_normal), 1.0f))) > relocalize_max_incidence) { streak.count = 0; return(false); }
+
+  // Where along the wall the beam lands, from where odom thinks the sensor is.
+  float along_wall = hits_end_wall ? odom.X_position + offset_X + reading_in*beam_X : odom.Y_position + offset_Y + reading_in*beam_Y;
+  if (fabs(along_wall) < relocalize_stake_clearance || fabs(along_wall) > field_half_width - relocalize_corner_clearance) { streak.count = 0; return(false); }
+
+  float wall = beam_along_normal > 0 ? field_half_width : -field_half_width;
+  float measured = wall - reading_in*beam_along_normal - (hits_end_wall ? offset_Y : offset_X);
+  float correction = measured - (hits_end_wall ? odom.Y_position : odom.X_position);
+  if (fabs(correction) > relocalize_max_correction) { streak.count = 0; return(false); }
+
+  // The correction, not the position, is compared so the robot driving between readings doesn't break the streak.
+  bool agrees = streak.count > 0 && streak.hits_end_wall == hits_end_wall && fabs(correction - streak.correction) <= relocalize_agreement;
+  streak.count = agrees ? streak.count + 1 : 1;
+  streak.hits_end_wall = hits_end_wall;
+  streak.correction = correction;
+  if (streak.count < relocalize_agreeing_readings) { return(false); }
+
+  // Tasks only switch when one yields, so this cannot land in the middle of the odom task's update.
+  if (hits_end_wall) { odom.correct_position(0, correction_gain*correction); }
+  else { odom.correct_position(correction_gain*correction, 0); }
+  streak.correction -= correction_gain*correction;
+  return(true);
 }
 
 /**
@@ -426,14 +1054,17 @@ void Drive::position_track(){
  */
 
 void Drive::set_heading(float orientation_deg){
-  //Gyro.setRotation(orientation_deg*gyro_scale/360.0, deg);
+  // get_absolute_heading() and odom read rotation, our turn functions read heading, so keep both in step.
+  Gyro.setRotation(orientation_deg*gyro_scale/360.0, deg);
   Gyro.setHeading(orientation_deg*gyro_scale/360.0, deg);
+  heading_rate_prev_time = -1;  // The rotation jumped, so don't read that as a turn rate.
 }
 
 /**
  * Resets the robot's coordinates and heading.
  * This is for odom-using robots to specify where the bot is at the beginning
- * of the match.
+ * of the match. The tracking task is only started the first time, so this
+ * can be called again later to re-zero the position.
  * 
  * @param X_position Robot's x in inches.
  * @param Y_position Robot's y in inches.
@@ -443,7 +1074,10 @@ void Drive::set_heading(float orientation_deg){
 void Drive::set_coordinates(float X_position, float Y_position, float orientation_deg){
   odom.set_position(X_position, Y_position, orientation_deg, get_ForwardTracker_position(), get_SidewaysTracker_position());
   set_heading(orientation_deg);
-  odom_task = task(position_track_task);
+  if (!odom_started){
+    odom_task = task(position_track_task);
+    odom_started = true;
+  }
 }
 
 /**
@@ -479,24 +1113,31 @@ float Drive::get_Y_position(){
  */
 
 void Drive::drive_to_point(float X_position, float Y_position){
-  drive_to_point(X_position, Y_position, drive_min_voltage, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  if (point_controller == MPC_CONTROLLER) { drive_to_point_mpc(X_position, Y_position); return; }
+  drive_to_point(X_position, Y_position, default_drive_params());
 }
 
 void Drive::drive_to_point(float X_position, float Y_position, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage){
-  drive_to_point(X_position, Y_position, drive_min_voltage, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_to_point(X_position, Y_position, default_drive_params().with_min_voltage(drive_min_voltage).with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage));
 }
 
 void Drive::drive_to_point(float X_position, float Y_position, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout){
-  drive_to_point(X_position, Y_position, drive_min_voltage, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_to_point(X_position, Y_position, default_drive_params().with_min_voltage(drive_min_voltage).with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage).with_exit(drive_settle_error, drive_settle_time, drive_timeout));
 }
 
 void Drive::drive_to_point(float X_position, float Y_position, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti){
-  PID drivePID(hypot(X_position-get_X_position(),Y_position-get_Y_position()), drive_kp, drive_ki, drive_kd, drive_starti, drive_settle_error, drive_settle_time, drive_timeout);
+  drive_params params = {drive_max_voltage, drive_min_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, {drive_kp, drive_ki, drive_kd, drive_starti}, {heading_kp, heading_ki, heading_kd, heading_starti}, boomerang_lead, boomerang_setback};
+  drive_to_point(X_position, Y_position, params);
+}
+
+void Drive::drive_to_point(float X_position, float Y_position, const drive_params &params){
+  PID drivePID(hypot(X_position-get_X_position(),Y_position-get_Y_position()), params.drive.kp, params.drive.ki, params.drive.kd, params.drive.starti, params.settle_error, params.settle_time, params.timeout);
   float start_angle_deg = to_deg(atan2(X_position-get_X_position(),Y_position-get_Y_position()));
-  PID headingPID(start_angle_deg-get_absolute_heading(), heading_kp, heading_ki, heading_kd, heading_starti);
+  PID headingPID(start_angle_deg-get_absolute_heading(), params.heading.kp, params.heading.ki, params.heading.kd, params.heading.starti);
   bool line_settled = false;
   bool prev_line_settled = is_line_settled(X_position, Y_position, start_angle_deg, get_X_position(), get_Y_position());
   while(!drivePID.is_settled()){
+    if (motion_terminated()) { break; }
     line_settled = is_line_settled(X_position, Y_position, start_angle_deg, get_X_position(), get_Y_position());
     if(line_settled && !prev_line_settled){ break; }
     prev_line_settled = line_settled;
@@ -505,21 +1146,22 @@ void Drive::drive_to_point(float X_position, float Y_position, float drive_min_v
     float heading_error = reduce_negative_180_to_180(to_deg(atan2(X_position-get_X_position(),Y_position-get_Y_position()))-get_absolute_heading());
     float drive_output = drivePID.compute(drive_error);
 
-    float heading_scale_factor = cos(to_rad(heading_error));
+    float heading_scale_factor = fast_cos(to_rad(heading_error));
     drive_output*=heading_scale_factor;
     heading_error = reduce_negative_90_to_90(heading_error);
     float heading_output = headingPID.compute(heading_error);
     
-    if (drive_error<drive_settle_error) { heading_output = 0; }
+    if (drive_error<params.settle_error) { heading_output = 0; }
 
-    drive_output = clamp(drive_output, -fabs(heading_scale_factor)*drive_max_voltage, fabs(heading_scale_factor)*drive_max_voltage);
-    heading_output = clamp(heading_output, -heading_max_voltage, heading_max_voltage);
+    drive_output = clamp(drive_output, -fabs(heading_scale_factor)*params.max_voltage, fabs(heading_scale_factor)*params.max_voltage);
+    heading_output = clamp(heading_output, -params.heading_max_voltage, params.heading_max_voltage);
 
-    drive_output = clamp_min_voltage(drive_output, drive_min_voltage);
+    drive_output = clamp_min_voltage(drive_output, params.min_voltage);
 
-    drive_with_voltage(left_voltage_scaling(drive_output, heading_output), right_voltage_scaling(drive_output, heading_output));
+    drive_with_turn_voltage(drive_output, heading_output);
     task::sleep(10);
   }
+  clear_terminators();
 }
 
 /**
@@ -542,32 +1184,42 @@ void Drive::drive_to_point(float X_position, float Y_position, float drive_min_v
  */
 
 void Drive::drive_to_pose(float X_position, float Y_position, float angle){
-  drive_to_pose(X_position, Y_position, angle, boomerang_lead, boomerang_setback, drive_min_voltage, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  if (point_controller == MPC_CONTROLLER) { drive_to_pose_mpc(X_position, Y_position, angle); return; }
+  drive_to_pose(X_position, Y_position, angle, default_drive_params());
 }
 
 void Drive::drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage){
-  drive_to_pose(X_position, Y_position, angle, lead, setback, drive_min_voltage, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_to_pose(X_position, Y_position, angle, default_drive_params().with_min_voltage(drive_min_voltage).with_boomerang(lead, setback));
 }
 
 void Drive::drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage){
-  drive_to_pose(X_position, Y_position, angle, lead, setback, drive_min_voltage, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_to_pose(X_position, Y_position, angle, default_drive_params().with_min_voltage(drive_min_voltage).with_boomerang(lead, setback).with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage));
 }
 
 
 void Drive::drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout){
-  drive_to_pose(X_position, Y_position, angle, lead, setback, drive_min_voltage, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  drive_to_pose(X_position, Y_position, angle, default_drive_params().with_min_voltage(drive_min_voltage).with_boomerang(lead, setback).with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage).with_exit(drive_settle_error, drive_settle_time, drive_timeout));
 }
 
 void Drive::drive_to_pose(float X_position, float Y_position, float angle, float lead, float setback, float drive_min_voltage, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti){
+  drive_params params = {drive_max_voltage, drive_min_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, {drive_kp, drive_ki, drive_kd, drive_starti}, {heading_kp, heading_ki, heading_kd, heading_starti}, lead, setback};
+  drive_to_pose(X_position, Y_position, angle, params);
+}
+
+void Drive::drive_to_pose(float X_position, float Y_position, float angle, const drive_params &params){
   float target_distance = hypot(X_position-get_X_position(),Y_position-get_Y_position());
-  PID drivePID(target_distance, drive_kp, drive_ki, drive_kd, drive_starti, drive_settle_error, drive_settle_time, drive_timeout);
-  PID headingPID(to_deg(atan2(X_position-get_X_position(),Y_position-get_Y_position()))-get_absolute_heading(), heading_kp, heading_ki, heading_kd, heading_starti);
+  PID drivePID(target_distance, params.drive.kp, params.drive.ki, params.drive.kd, params.drive.starti, params.settle_error, params.settle_time, params.timeout);
+  PID headingPID(to_deg(atan2(X_position-get_X_position(),Y_position-get_Y_position()))-get_absolute_heading(), params.heading.kp, params.heading.ki, params.heading.kd, params.heading.starti);
   bool line_settled = is_line_settled(X_position, Y_position, angle, get_X_position(), get_Y_position());
   bool prev_line_settled = is_line_settled(X_position, Y_position, angle, get_X_position(), get_Y_position());
   bool crossed_center_line = false;
   bool center_line_side = is_line_settled(X_position, Y_position, angle+90, get_X_position(), get_Y_position());
   bool prev_center_line_side = center_line_side;
+  // The target heading does not change, so its direction only needs working out once.
+  float sin_angle, cos_angle;
+  fast_sincos_deg(angle, sin_angle, cos_angle);
   while(!drivePID.is_settled()){
+    if (motion_terminated()) { break; }
     line_settled = is_line_settled(X_position, Y_position, angle, get_X_position(), get_Y_position());
     if(line_settled && !prev_line_settled){ break; }
     prev_line_settled = line_settled;
@@ -579,32 +1231,201 @@ void Drive::drive_to_pose(float X_position, float Y_position, float angle, float
 
     target_distance = hypot(X_position-get_X_position(),Y_position-get_Y_position());
 
-    float carrot_X = X_position - sin(to_rad(angle)) * (lead * target_distance + setback);
-    float carrot_Y = Y_position - cos(to_rad(angle)) * (lead * target_distance + setback);
+    float carrot_X = X_position - sin_angle * (params.lead * target_distance + params.setback);
+    float carrot_Y = Y_position - cos_angle * (params.lead * target_distance + params.setback);
 
     float drive_error = hypot(carrot_X-get_X_position(),carrot_Y-get_Y_position());
     float heading_error = reduce_negative_180_to_180(to_deg(atan2(carrot_X-get_X_position(),carrot_Y-get_Y_position()))-get_absolute_heading());
 
-    if (drive_error<drive_settle_error || crossed_center_line || drive_error < setback) { 
+    if (drive_error<params.settle_error || crossed_center_line || drive_error < params.setback) { 
       heading_error = reduce_negative_180_to_180(angle-get_absolute_heading()); 
       drive_error = target_distance;
     }
     
     float drive_output = drivePID.compute(drive_error);
 
-    float heading_scale_factor = cos(to_rad(heading_error));
+    float heading_scale_factor = fast_cos(to_rad(heading_error));
     drive_output*=heading_scale_factor;
     heading_error = reduce_negative_90_to_90(heading_error);
     float heading_output = headingPID.compute(heading_error);
 
-    drive_output = clamp(drive_output, -fabs(heading_scale_factor)*drive_max_voltage, fabs(heading_scale_factor)*drive_max_voltage);
-    heading_output = clamp(heading_output, -heading_max_voltage, heading_max_voltage);
+    drive_output = clamp(drive_output, -fabs(heading_scale_factor)*params.max_voltage, fabs(heading_scale_factor)*params.max_voltage);
+    heading_output = clamp(heading_output, -params.heading_max_voltage, params.heading_max_voltage);
 
-    drive_output = clamp_min_voltage(drive_output, drive_min_voltage);
+    drive_output = clamp_min_voltage(drive_output, params.min_voltage);
 
-    drive_with_voltage(left_voltage_scaling(drive_output, heading_output), right_voltage_scaling(drive_output, heading_output));
+    drive_with_turn_voltage(drive_output, heading_output);
     task::sleep(10);
   }
+  clear_terminators();
+}
+
+/**
+ * Drives to a point with the model-predictive controller instead of the
+ * drive and heading PIDs. Every loop it plans the wheel speeds for the
+ * next MPC_HORIZON steps under the wheel speed and acceleration limits
+ * from set_drive_model_constants(), so the robot turns toward the point
+ * while it speeds up, runs at the speed limit, and brakes as hard as the
+ * model allows. It will back up to the point if that is faster. Used by
+ * drive_to_point() when point_controller is MPC_CONTROLLER.
+ * 
+ * @param X_position Desired x position in inches.
+ * @param Y_position Desired y position in inches.
+ * @param drive_max_voltage Max voltage out of 12; scales the wheel speed limit.
+ */
+
+void Drive::drive_to_point_mpc(float X_position, float Y_position){
+  mpc_motion(X_position, Y_position, false, 0, drive_max_voltage, drive_settle_error, drive_settle_time, drive_timeout);
+}
+
+void Drive::drive_to_point_mpc(float X_position, float Y_position, float drive_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout){
+  mpc_motion(X_position, Y_position, false, 0, drive_max_voltage, drive_settle_error, drive_settle_time, drive_timeout);
+}
+
+/**
+ * Drives to a pose with the model-predictive controller. Like
+ * drive_to_point_mpc(), plus costs on the distance from the line through
+ * the target along the desired angle and on the heading, so the robot
+ * lines up on the way in instead of chasing a carrot. It settles only
+ * once the heading is also within turn_settle_error.
+ * 
+ * @param X_position Desired x position in inches.
+ * @param Y_position Desired y position in inches.
+ * @param angle Desired orientation in degrees.
+ */
+
+void Drive::drive_to_pose_mpc(float X_position, float Y_position, float angle){
+  mpc_motion(X_position, Y_position, true, angle, drive_max_voltage, drive_settle_error, drive_settle_time, drive_timeout);
+}
+
+void Drive::drive_to_pose_mpc(float X_position, float Y_position, float angle, float drive_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout){
+  mpc_motion(X_position, Y_position, true, angle, drive_max_voltage, drive_settle_error, drive_settle_time, drive_timeout);
+}
+
+void Drive::mpc_motion(float X_position, float Y_position, bool use_angle, float angle, float drive_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout){
+  if (max_wheel_speed <= 0) { return; }  // No drive model, so there is nothing to plan with
+  mpc.speed_limit = max_wheel_speed*fmin(drive_max_voltage, 12)/12.0;
+  // The model's left wheel is the one that turns the robot clockwise (see clockwise_side()).
+  mpc.reset(clockwise_side().velocity(dps)*drive_in_to_deg_ratio, counterclockwise_side().velocity(dps)*drive_in_to_deg_ratio);
+  float time_settled = 0;
+  double start_time = Brain.Timer.value()*1000.0;
+  double next_loop_time = start_time;
+
+  while(true){
+    if (motion_terminated()) { break; }
+    double now = Brain.Timer.value()*1000.0;
+    float heading = get_absolute_heading();
+    bool settled = hypot(X_position-get_X_position(), Y_position-get_Y_position()) < drive_settle_error;
+    if (use_angle) { settled = settled && fabs(reduce_negative_180_to_180(angle-heading)) < turn_settle_error; }
+    if (settled) { time_settled += mpc.update_period; }
+    else { time_settled = 0; }
+    if (settled && time_settled >= drive_settle_time) { break; }
+    if (drive_timeout != 0 && now - start_time >= drive_timeout) { break; }
+
+    if (use_angle) { mpc.compute(get_X_position(), get_Y_position(), heading, X_position, Y_position, angle); }
+    else { mpc.compute(get_X_position(), get_Y_position(), heading, X_position, Y_position); }
+
+    float left_voltage = 12.0*mpc.left_speed/max_wheel_speed + wheel_accel_voltage*mpc.left_accel;
+    float right_voltage = 12.0*mpc.right_speed/max_wheel_speed + wheel_accel_voltage*mpc.right_accel;
+    drive_with_side_voltages(clamp(left_voltage, -12, 12), clamp(right_voltage, -12, 12));
+
+    next_loop_time += mpc.update_period;
+    now = Brain.Timer.value()*1000.0;
+    if (next_loop_time > now) { task::sleep(static_cast<uint32_t>(next_loop_time - now)); }
+    else { next_loop_time = now; }
+  }
+  drive_stop(brake);
+  clear_terminators();
+}
+
+/**
+ * Plans the fastest trajectory along a path that this robot can follow,
+ * using the drive model and trajectory constants. Starts and ends stopped.
+ * 
+ * @param points Path points, about evenly spaced (see sample_path()).
+ * @param point_count Number of points.
+ * @param trajectory Output array, point_count long.
+ * @return Number of trajectory points written.
+ */
+
+int Drive::plan_trajectory(const path_point *points, int point_count, trajectory_point *trajectory){
+  trajectory_constraints constraints;
+  constraints.max_wheel_speed = max_wheel_speed;
+  constraints.max_wheel_accel = max_wheel_accel;
+  constraints.max_centripetal_accel = max_centripetal_accel;
+  constraints.track_width = track_width;
+  constraints.start_velocity = 0;
+  constraints.end_velocity = 0;
+  return(::plan_trajectory(points, point_count, constraints, trajectory));
+}
+
+/**
+ * Follows a planned trajectory in time. The wheel speeds and
+ * accelerations of the trajectory are fed forward through the drive
+ * model, and a RAMSETE controller corrects for the difference between
+ * where odom says the robot is and where the trajectory says it should
+ * be. The motion ends when the trajectory's time is up and the robot
+ * is within drive_settle_error of the end, or at drive_timeout past the
+ * trajectory's time.
+ * 
+ * @param trajectory Planned trajectory (see plan_trajectory()).
+ * @param point_count Number of points.
+ * @param reversed Drive the path backwards (the back of the robot leads).
+ */
+
+void Drive::follow_trajectory(const trajectory_point *trajectory, int point_count, bool reversed){
+  if (point_count < 2 || max_wheel_speed <= 0) { return; }
+  float half_track = track_width/2;
+  float end_time = trajectory[point_count-1].time;
+  const trajectory_point &end = trajectory[point_count-1];
+  double start_time = Brain.Timer.value()*1000.0;
+  double next_loop_time = start_time;
+
+  while(true){
+    if (motion_terminated()) { break; }
+    double now = Brain.Timer.value()*1000.0;
+    float t = (now - start_time)/1000.0;
+    float X = get_X_position();
+    float Y = get_Y_position();
+    if (t >= end_time && hypot(end.x-X, end.y-Y) < drive_settle_error) { break; }
+    if (t >= end_time + drive_timeout/1000.0) { break; }
+
+    trajectory_point target = sample_trajectory(trajectory, point_count, t);
+    float velocity = reversed ? -target.velocity : target.velocity;
+    float accel = reversed ? -target.acceleration : target.acceleration;
+    float turn_rate = target.velocity*target.curvature;  // rad/s clockwise, the same either way round
+    float target_heading = reversed ? target.heading_deg + 180 : target.heading_deg;
+
+    // Error in the robot's frame: ahead and to the right.
+    float heading = get_absolute_heading();
+    float sin_heading, cos_heading;
+    fast_sincos_deg(heading, sin_heading, cos_heading);
+    float error_ahead = (target.x-X)*sin_heading + (target.y-Y)*cos_heading;
+    float error_right = (target.x-X)*cos_heading - (target.y-Y)*sin_heading;
+    float error_heading = to_rad(reduce_negative_180_to_180(target_heading - heading));
+
+    float gain = 2*ramsete_zeta*sqrt(turn_rate*turn_rate + ramsete_beta*velocity*velocity);
+    float sinc = fabs(error_heading) < 1e-3 ? 1 : sin(error_heading)/error_heading;
+    float command_velocity = velocity*cos(error_heading) + gain*error_ahead;
+    float command_turn_rate = turn_rate + gain*error_heading + ramsete_beta*velocity*sinc*error_right;
+
+    float left_speed = command_velocity + command_turn_rate*half_track;
+    float right_speed = command_velocity - command_turn_rate*half_track;
+    float turn_accel = target.acceleration*target.curvature;  // Like turn_rate, the same either way round
+    float left_accel = accel + turn_accel*half_track;
+    float right_accel = accel - turn_accel*half_track;
+    float left_voltage = 12.0*left_speed/max_wheel_speed + wheel_accel_voltage*left_accel;
+    float right_voltage = 12.0*right_speed/max_wheel_speed + wheel_accel_voltage*right_accel;
+    // Left here is the wheel that speeds up to turn clockwise (see clockwise_side()).
+    drive_with_side_voltages(clamp(left_voltage, -12, 12), clamp(right_voltage, -12, 12));
+
+    next_loop_time += 10;
+    now = Brain.Timer.value()*1000.0;
+    if (next_loop_time > now) { task::sleep(static_cast<uint32_t>(next_loop_time - now)); }
+    else { next_loop_time = now; }
+  }
+  drive_stop(brake);
+  clear_terminators();
 }
 
 /**
@@ -620,26 +1441,26 @@ void Drive::drive_to_pose(float X_position, float Y_position, float angle, float
  */
 
 void Drive::turn_to_point(float X_position, float Y_position){
-  turn_to_point(X_position, Y_position, 0, turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, turn_kp, turn_ki, turn_kd, turn_starti);
+  turn_to_point(X_position, Y_position, 0, default_turn_params());
 }
 
 void Drive::turn_to_point(float X_position, float Y_position, float extra_angle_deg){
-  turn_to_point(X_position, Y_position, extra_angle_deg, turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, turn_kp, turn_ki, turn_kd, turn_starti);
+  turn_to_point(X_position, Y_position, extra_angle_deg, default_turn_params());
 }
 
 void Drive::turn_to_point(float X_position, float Y_position, float extra_angle_deg, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout){
-  turn_to_point(X_position, Y_position, extra_angle_deg, turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, turn_kp, turn_ki, turn_kd, turn_starti);
+  turn_to_point(X_position, Y_position, extra_angle_deg, default_turn_params().with_max_voltage(turn_max_voltage).with_exit(turn_settle_error, turn_settle_time, turn_timeout));
 }
 
 void Drive::turn_to_point(float X_position, float Y_position, float extra_angle_deg, float turn_max_voltage, float turn_settle_error, float turn_settle_time, float turn_timeout, float turn_kp, float turn_ki, float turn_kd, float turn_starti){
-  PID turnPID(reduce_negative_180_to_180(to_deg(atan2(X_position-get_X_position(),Y_position-get_Y_position())) - get_absolute_heading()), turn_kp, turn_ki, turn_kd, turn_starti, turn_settle_error, turn_settle_time, turn_timeout);
-  while(turnPID.is_settled() == false){
-    float error = reduce_negative_180_to_180(to_deg(atan2(X_position-get_X_position(),Y_position-get_Y_position())) - get_absolute_heading() + extra_angle_deg);
-    float output = turnPID.compute(error);
-    output = clamp(output, -turn_max_voltage, turn_max_voltage);
-    drive_with_voltage(output, -output);
-    task::sleep(10);
-  }
+  turn_params params = {turn_max_voltage, turn_settle_error, turn_settle_time, turn_timeout, {turn_kp, turn_ki, turn_kd, turn_starti}};
+  turn_to_point(X_position, Y_position, extra_angle_deg, params);
+}
+
+void Drive::turn_to_point(float X_position, float Y_position, float extra_angle_deg, const turn_params &params){
+  //Turning in place does not move the robot, so the angle to the point is worked out once and handed to the turn engine
+  float angle = to_deg(atan2(X_position-get_X_position(),Y_position-get_Y_position())) + extra_angle_deg;
+  turn_to_angle(reduce_0_to_360(angle), params);
 }
 
 /**
@@ -647,7 +1468,8 @@ void Drive::turn_to_point(float X_position, float Y_position, float extra_angle_
  * Uses two PID loops, one drive and one heading to drive and turn
  * at the same time. Optimized to turn the quicker direction and only
  * exits once both PID loops have settled. It uses the heading constants
- * for heading but the turn exit conditions to settle.
+ * for heading but the turn exit conditions to settle. Needs the
+ * HolonomicMotors constructor.
  * 
  * @param X_position Desired x position in inches.
  * @param Y_position Desired y position in inches.
@@ -655,69 +1477,141 @@ void Drive::turn_to_point(float X_position, float Y_position, float extra_angle_
  */
 
 void Drive::holonomic_drive_to_pose(float X_position, float Y_position){
-  holonomic_drive_to_pose(X_position, Y_position, get_absolute_heading(), drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  holonomic_drive_to_pose(X_position, Y_position, get_absolute_heading(), default_drive_params());
 }
 
 void Drive::holonomic_drive_to_pose(float X_position, float Y_position, float angle){
-  holonomic_drive_to_pose(X_position, Y_position, angle, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  holonomic_drive_to_pose(X_position, Y_position, angle, default_drive_params());
 }
 
 void Drive::holonomic_drive_to_pose(float X_position, float Y_position, float angle, float drive_max_voltage, float heading_max_voltage){
-  holonomic_drive_to_pose(X_position, Y_position, angle, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  holonomic_drive_to_pose(X_position, Y_position, angle, default_drive_params().with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage));
 }
 
 void Drive::holonomic_drive_to_pose(float X_position, float Y_position, float angle, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout){
-  holonomic_drive_to_pose(X_position, Y_position, angle, drive_max_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, drive_kp, drive_ki, drive_kd, drive_starti, heading_kp, heading_ki, heading_kd, heading_starti);
+  holonomic_drive_to_pose(X_position, Y_position, angle, default_drive_params().with_max_voltage(drive_max_voltage).with_heading_max_voltage(heading_max_voltage).with_exit(drive_settle_error, drive_settle_time, drive_timeout));
 }
 
 void Drive::holonomic_drive_to_pose(float X_position, float Y_position, float angle, float drive_max_voltage, float heading_max_voltage, float drive_settle_error, float drive_settle_time, float drive_timeout, float drive_kp, float drive_ki, float drive_kd, float drive_starti, float heading_kp, float heading_ki, float heading_kd, float heading_starti){
-  PID drivePID(hypot(X_position-get_X_position(),Y_position-get_Y_position()), drive_kp, drive_ki, drive_kd, drive_starti, drive_settle_error, drive_settle_time, drive_timeout);
-  PID turnPID(angle-get_absolute_heading(), heading_kp, heading_ki, heading_kd, heading_starti, turn_settle_error, turn_settle_time, turn_timeout);
+  drive_params params = {drive_max_voltage, drive_min_voltage, heading_max_voltage, drive_settle_error, drive_settle_time, drive_timeout, {drive_kp, drive_ki, drive_kd, drive_starti}, {heading_kp, heading_ki, heading_kd, heading_starti}, boomerang_lead, boomerang_setback};
+  holonomic_drive_to_pose(X_position, Y_position, angle, params);
+}
+
+void Drive::holonomic_drive_to_pose(float X_position, float Y_position, float angle, const drive_params &params){
+  if (holonomic_motors == NULL) { return; }
+  PID drivePID(hypot(X_position-get_X_position(),Y_position-get_Y_position()), params.drive.kp, params.drive.ki, params.drive.kd, params.drive.starti, params.settle_error, params.settle_time, params.timeout);
+  PID turnPID(angle-get_absolute_heading(), params.heading.kp, params.heading.ki, params.heading.kd, params.heading.starti, turn_settle_error, turn_settle_time, turn_timeout);
   while( !(drivePID.is_settled() && turnPID.is_settled()) ){
+    if (motion_terminated()) { break; }
     float drive_error = hypot(X_position-get_X_position(),Y_position-get_Y_position());
     float turn_error = reduce_negative_180_to_180(angle-get_absolute_heading());
 
     float drive_output = drivePID.compute(drive_error);
     float turn_output = turnPID.compute(turn_error);
 
-    drive_output = clamp(drive_output, -drive_max_voltage, drive_max_voltage);
-    turn_output = clamp(turn_output, -heading_max_voltage, heading_max_voltage);
+    drive_output = clamp(drive_output, -params.max_voltage, params.max_voltage);
+    turn_output = clamp(turn_output, -params.heading_max_voltage, params.heading_max_voltage);
 
     float heading_error = atan2(Y_position-get_Y_position(), X_position-get_X_position());
 
-    DriveLF.spin(fwd, drive_output*cos(to_rad(get_absolute_heading()) + heading_error - M_PI/4) + turn_output, volt);
-    DriveLB.spin(fwd, drive_output*cos(-to_rad(get_absolute_heading()) - heading_error + 3*M_PI/4) + turn_output, volt);
-    DriveRB.spin(fwd, drive_output*cos(to_rad(get_absolute_heading()) + heading_error - M_PI/4) - turn_output, volt);
-    DriveRF.spin(fwd, drive_output*cos(-to_rad(get_absolute_heading()) - heading_error + 3*M_PI/4) - turn_output, volt);
+    holonomic_motors->DriveLF.spin(fwd, drive_output*cos(to_rad(get_absolute_heading()) + heading_error - M_PI/4) + turn_output, volt);
+    holonomic_motors->DriveLB.spin(fwd, drive_output*cos(-to_rad(get_absolute_heading()) - heading_error + 3*M_PI/4) + turn_output, volt);
+    holonomic_motors->DriveRB.spin(fwd, drive_output*cos(to_rad(get_absolute_heading()) + heading_error - M_PI/4) - turn_output, volt);
+    holonomic_motors->DriveRF.spin(fwd, drive_output*cos(-to_rad(get_absolute_heading()) - heading_error + 3*M_PI/4) - turn_output, volt);
     task::sleep(10);
   }
+  clear_terminators();
+}
+
+/**
+ * Applies the selected stick curve to a deadbanded joystick value.
+ * 
+ * @param input Joystick value in percent.
+ * @param curve Which curve to use.
+ * @param curve_gain Exponential gain, or cubic weight.
+ * @return The curved joystick value in percent.
+ */
+
+float Drive::shape_driver_input(float input, driver_curve curve, float curve_gain){
+  if (curve == EXPONENTIAL_CURVE){
+    return(exponential_curve(input, curve_gain));
+  }
+  if (curve == CUBIC_CURVE){
+    return(cubic_curve(input, curve_gain));
+  }
+  return(input);
 }
 
 /**
  * Controls a chassis with left stick throttle and right stick turning.
- * Default deadband is 5.
+ * Both sticks go through the deadband and curve from set_driver_constants()
+ * and set_driver_curves(). If the two together would ask for more than
+ * 12 volts, throttle is given up first so the robot still turns as commanded.
+ * With heading_hold_enabled, the heading is held while driving with the
+ * turn stick released.
  */
 
 void Drive::control_arcade(){
-  float throttle = deadband(controller(primary).Axis3.value(), 5);
-  float turn = deadband(controller(primary).Axis1.value(), 5)/0.8;  //divide the turn reading by 0.8 to account for high COG of the robot
-  DriveL.spin(fwd, to_volt(throttle-turn), volt);
-  DriveR.spin(fwd, to_volt(throttle+turn), volt);
+  control_arcade(controller(primary).Axis3.value(), controller(primary).Axis1.value());
+}
+
+void Drive::control_arcade(float throttle_input, float turn_input){
+  float throttle = shape_driver_input(deadband(throttle_input, driver_deadband), throttle_curve, throttle_curve_gain);
+  float turn = shape_driver_input(deadband(turn_input, driver_deadband), turn_curve, turn_curve_gain)*driver_turn_scale;
+  float throttle_voltage = to_volt(throttle);
+  float turn_voltage = to_volt(turn);
+
+  if (heading_hold_enabled){
+    double now = Brain.Timer.value();
+    float heading = get_absolute_heading();
+    float heading_rate = 0;
+    if (heading_hold_prev_time >= 0 && now > heading_hold_prev_time){
+      heading_rate = reduce_negative_180_to_180(heading - heading_hold_prev_heading)/(now - heading_hold_prev_time);
+    }
+    heading_hold_prev_heading = heading;
+    heading_hold_prev_time = now;
+    // Where the robot will be pointing by the time this output reaches the motors.
+    float predicted_heading = heading + heading_rate*heading_hold_latency/1000.0;
+
+    if (turn == 0 && throttle != 0){
+      if (!heading_hold_active){
+        heading_hold_active = true;
+        heading_hold_target = reduce_0_to_360(predicted_heading);
+        heading_hold_prev_error = 0;
+      }
+      float error = reduce_negative_180_to_180(heading_hold_target - predicted_heading);
+      turn_voltage = heading_hold_kp*error + heading_hold_kd*(error - heading_hold_prev_error);
+      turn_voltage = clamp(turn_voltage, -heading_hold_max_voltage, heading_hold_max_voltage);
+      heading_hold_prev_error = error;
+    } else {
+      heading_hold_active = false;
+    }
+  }
+
+  // Turn desaturation: take any voltage over 12 out of the throttle so the turn is kept.
+  turn_voltage = clamp(turn_voltage, -12, 12);
+  float excess_voltage = std::fabs(throttle_voltage) + std::fabs(turn_voltage) - 12;
+  if (excess_voltage > 0){
+    throttle_voltage = throttle_voltage > 0 ? throttle_voltage - excess_voltage : throttle_voltage + excess_voltage;
+  }
+
+  drive_with_side_voltages(throttle_voltage+turn_voltage, throttle_voltage-turn_voltage);
 }
 
 /**
  * Controls a chassis with left stick throttle and strafe, and right stick turning.
- * Default deadband is 5.
+ * Default deadband is 5. Does nothing without HolonomicMotors.
  */
 
 void Drive::control_holonomic(){
+  if (holonomic_motors == NULL) { return; }
   float throttle = deadband(controller(primary).Axis3.value(), 5);
   float turn = deadband(controller(primary).Axis1.value(), 5);
   float strafe = deadband(controller(primary).Axis4.value(), 5);
-  DriveLF.spin(fwd, to_volt(throttle+turn+strafe), volt);
-  DriveRF.spin(fwd, to_volt(throttle-turn-strafe), volt);
-  DriveLB.spin(fwd, to_volt(throttle+turn-strafe), volt);
-  DriveRB.spin(fwd, to_volt(throttle-turn+strafe), volt);
+  holonomic_motors->DriveLF.spin(fwd, to_volt(throttle+turn+strafe), volt);
+  holonomic_motors->DriveRF.spin(fwd, to_volt(throttle-turn-strafe), volt);
+  holonomic_motors->DriveLB.spin(fwd, to_volt(throttle+turn-strafe), volt);
+  holonomic_motors->DriveRB.spin(fwd, to_volt(throttle-turn+strafe), volt);
 }
 
 /**
@@ -0,0 +1,320 @@
+#include "vex.h"
+
+/**
+ * Solves a small dense quadratic program:
+ *   minimize 0.5*x'Hx + g'x  subject to  lower <= Ax <= upper
+ * with ADMM (the OSQP iteration). The KKT matrix is factored once with
+ * Cholesky, then each iteration is two triangular solves, two products
+ * with the sparse A and a clamp, so the cost per call is fixed.
+ * Everything is in caller-owned arrays; nothing is allocated.
+ *
+ * @param variable_count Number of variables, n.
+ * @param constraint_count Number of constraint rows, m.
+ * @param hessian n*n row-major H (symmetric, positive semidefinite).
+ * @param gradient Length n g.
+ * @param row_start Length m+1. Row k of A is entries row_start[k] to row_start[k+1]-1.
+ * @param columns Column of each nonzero of A.
+ * @param values Value of each nonzero of A.
+ * @param lower_bounds Length m.
+ * @param upper_bounds Length m.
+ * @param solution Length n. Holds the warm start on entry and the answer on return.
+ * @param iterations Number of ADMM iterations to run.
+ * @param work At least n*n + 2*m + 2*n floats of scratch.
+ */
+
+void qp_solve(int variable_count, int constraint_count, const float *hessian, const float *gradient, const int *row_start, const int *columns, const float *values, const float *lower_bounds, const float *upper_bounds, float *solution, int iterations, float *work){
+  const int n = variable_count;
+  const int m = constraint_count;
+  const float sigma = 1e-6;
+  const float rho = 0.1;
+  const float alpha = 1.6;
+  float *kkt = work;
+  float *z = kkt + n*n;
+  float *y = z + m;
+  float *rhs = y + m;
+  float *x_tilde = rhs + n;
+
+  // kkt = H + sigma*I + rho*A'A, then factored in place into its lower Cholesky factor.
+  for(int i = 0; i < n; i++){
+    for(int j = 0; j <= i; j++){
+      kkt[i*n+j] = hessian[i*n+j] + (i == j ? sigma : 0);
+    }
+  }
+  for(int k = 0; k < m; k++){
+    for(int a = row_start[k]; a < row_start[k+1]; a++){
+      for(int b = row_start[k]; b < row_start[k+1]; b++){
+        if(columns[b] <= columns[a]){ kkt[columns[a]*n+columns[b]] += rho*values[a]*values[b]; }
+      }
+    }
+  }
+  for(int j = 0; j < n; j++){
+    float diagonal = kkt[j*n+j];
+    for(int k = 0; k < j; k++){ diagonal -= kkt[j*n+k]*kkt[j*n+k]; }
+    diagonal = sqrt(fmax(diagonal, 1e-9f));
+    kkt[j*n+j] = diagonal;
+    for(int i = j+1; i < n; i++){
+      float sum = kkt[i*n+j];
+      for(int k = 0; k < j; k++){ sum -= kkt[i*n+k]*kkt[j*n+k]; }
+      kkt[i*n+j] = sum/diagonal;
+    }
+  }
+
+  for(int k = 0; k < m; k++){
+    float row = 0;
+    for(int a = row_start[k]; a < row_start[k+1]; a++){ row += values[a]*solution[columns[a]]; }
+    z[k] = clamp(row, lower_bounds[k], upper_bounds[k]);
+    y[k] = 0;
+  }
+
+  for(int iteration = 0; iteration < iterations; iteration++){
+    for(int i = 0; i < n; i++){ rhs[i] = sigma*solution[i] - gradient[i]; }
+    for(int k = 0; k < m; k++){
+      float dual = rho*z[k] - y[k];
+      for(int a = row_start[k]; a < row_start[k+1]; a++){ rhs[columns[a]] += values[a]*dual; }
+    }
+    // Forward then back substitution through the Cholesky factor.
+    for(int i = 0; i < n; i++){
+      float sum = rhs[i];
+      for(int k = 0; k < i; k++){ sum -= kkt[i*n+k]*x_tilde[k]; }
+      x_tilde[i] = sum/kkt[i*n+i];
+    }
+    for(int i = n-1; i >= 0; i--){
+      float sum = x_tilde[i];
+      for(int k = i+1; k < n; k++){ sum -= kkt[k*n+i]*x_tilde[k]; }
+      x_tilde[i] = sum/kkt[i*n+i];
+    }
+    for(int k = 0; k < m; k++){
+      float row = 0;
+      for(int a = row_start[k]; a < row_start[k+1]; a++){ row += values[a]*x_tilde[columns[a]]; }
+      float relaxed = alpha*row + (1-alpha)*z[k];
+      float z_new = clamp(relaxed + y[k]/rho, lower_bounds[k], upper_bounds[k]);
+      y[k] += rho*(relaxed - z_new);
+      z[k] = z_new;
+    }
+    for(int i = 0; i < n; i++){ solution[i] = alpha*x_tilde[i] + (1-alpha)*solution[i]; }
+  }
+}
+
+MPC::MPC(){
+  for(int i = 0; i < MPC_VARIABLES; i++){ plan[i] = 0; }
+}
+
+/**
+ * Sets the drive model. The speed and acceleration limits are per wheel,
+ * so a turn in place and a straight line get the same limits.
+ *
+ * @param max_wheel_speed Wheel surface speed at 12 volts in in/s.
+ * @param max_wheel_accel Largest wheel acceleration in in/s^2 that doesn't slip or brown out.
+ * @param track_width Distance between the left and right wheels in inches.
+ */
+
+void MPC::set_model(float max_wheel_speed, float max_wheel_accel, float track_width){
+  this->max_wheel_speed = max_wheel_speed;
+  this->max_wheel_accel = max_wheel_accel;
+  this->track_width = track_width;
+  this->speed_limit = max_wheel_speed;
+  build_constraints();
+}
+
+/**
+ * Starts a new move from the given wheel speeds. The whole plan is reset
+ * to holding those speeds, which is the first linearization point.
+ *
+ * @param left_speed Current left wheel speed in in/s.
+ * @param right_speed Current right wheel speed in in/s.
+ */
+
+void MPC::reset(float left_speed, float right_speed){
+  this->left_speed = left_speed;
+  this->right_speed = right_speed;
+  left_accel = 0;
+  right_accel = 0;
+  for(int k = 0; k < MPC_HORIZON; k++){
+    plan[k] = (left_speed+right_speed)/2;
+    plan[MPC_HORIZON+k] = (left_speed-right_speed)/2;
+  }
+}
+
+/**
+ * Fills the constraint matrix. The variables are the forward speed v_k
+ * for each step, then the turn part of the wheel speed w_k (left wheel
+ * = v+w, right = v-w). Each step has four rows: left and right wheel
+ * speed, and left and right wheel change from the step before. Only the
+ * bounds change from tick to tick.
+ */
+
+void MPC::build_constraints(){
+  int count = 0;
+  for(int k = 0; k < MPC_HORIZON; k++){
+    for(int row = 0; row < 4; row++){
+      // Rows 0 and 2 are the left wheel (v+w), rows 1 and 3 the right (v-w).
+      float turn_sign = (row % 2 == 0) ? 1 : -1;
+      constraint_rows[4*k+row] = count;
+      if(row >= 2 && k > 0){
+        constraint_columns[count] = k-1; constraint_values[count++] = -1;
+        constraint_columns[count] = MPC_HORIZON+k-1; constraint_values[count++] = -turn_sign;
+      }
+      constraint_columns[count] = k; constraint_values[count++] = 1;
+      constraint_columns[count] = MPC_HORIZON+k; constraint_values[count++] = turn_sign;
+    }
+  }
+  constraint_rows[MPC_CONSTRAINTS] = count;
+}
+
+/**
+ * Plans toward a point, arriving at whatever heading is natural.
+ * Call once per update_period and send left/right speed and accel to
+ * the motors.
+ *
+ * @param X_position Robot x in inches.
+ * @param Y_position Robot y in inches.
+ * @param heading_deg Robot heading in degrees.
+ * @param target_X Target x in inches.
+ * @param target_Y Target y in inches.
+ */
+
+void MPC::compute(float X_position, float Y_position, float heading_deg, float target_X, float target_Y){
+  solve(X_position, Y_position, heading_deg, target_X, target_Y, false, 0);
+}
+
+/**
+ * Plans toward a pose. Adds a cost on the distance from the line through
+ * the target along its heading, so the robot comes in straight, and on
+ * the heading, which fades in over heading_blend_distance.
+ *
+ * @param X_position Robot x in inches.
+ * @param Y_position Robot y in inches.
+ * @param heading_deg Robot heading in degrees.
+ * @param target_X Target x in inches.
+ * @param target_Y Target y in inches.
+ * @param target_angle_deg Target heading in degrees.
+ */
+
+void MPC::compute(float X_position, float Y_position, float heading_deg, float target_X, float target_Y, float target_angle_deg){
+  solve(X_position, Y_position, heading_deg, target_X, target_Y, true, target_angle_deg);
+}
+
+/**
+ * One real-time iteration: roll the last plan out through the nonlinear
+ * model, linearize about it, build and solve the QP for the whole new
+ * plan, then ramp the wheels toward its first step.
+ */
+
+void MPC::solve(float X_position, float Y_position, float heading_deg, float target_X, float target_Y, bool use_angle, float target_angle_deg){
+  const int N = MPC_HORIZON;
+  const int n = MPC_VARIABLES;
+  const float dt = step_time;
+  const float turn_scale = dt/(track_width/2);  // Heading change per step for each in/s of w
+
+  for(int i = 0; i < n*n; i++){ hessian[i] = 0; }
+  for(int i = 0; i < n; i++){ gradient[i] = 0; }
+
+  // Stage cost matrix: position_weight*I, plus cross_track_weight along the normal of the approach line.
+  float normal_X = 0, normal_Y = 0;
+  if(use_angle){
+    float sin_angle, cos_angle;
+    fast_sincos_deg(target_angle_deg, sin_angle, cos_angle);
+    normal_X = cos_angle;
+    normal_Y = -sin_angle;
+  }
+  float cross_weight = use_angle ? cross_track_weight : 0;
+  float Q[2][2] = {{position_weight + cross_weight*normal_X*normal_X, cross_weight*normal_X*normal_Y},
+                   {cross_weight*normal_X*normal_Y, position_weight + cross_weight*normal_Y*normal_Y}};
+
+  // Jacobian of the position after m steps, built up one step at a time.
+  float jacobian[2][MPC_VARIABLES];
+  for(int i = 0; i < n; i++){ jacobian[0][i] = 0; jacobian[1][i] = 0; }
+  float nominal_X = X_position, nominal_Y = Y_position;
+  float nominal_heading = to_rad(heading_deg);
+  for(int m = 0; m < N; m++){
+    float sin_heading, cos_heading;
+    fast_sincos(nominal_heading, sin_heading, cos_heading);
+    float lever = dt*plan[m]*turn_scale;
+    for(int j = 0; j < m; j++){
+      jacobian[0][N+j] += lever*cos_heading;
+      jacobian[1][N+j] -= lever*sin_heading;
+    }
+    jacobian[0][m] = dt*sin_heading;
+    jacobian[1][m] = dt*cos_heading;
+    nominal_X += dt*plan[m]*sin_heading;
+    nominal_Y += dt*plan[m]*cos_heading;
+    nominal_heading += turn_scale*plan[N+m];
+
+    // Residual of the linearized position at zero plan: nominal - target - J*plan.
+    float residual[2] = {nominal_X - target_X, nominal_Y - target_Y};
+    for(int i = 0; i <= m; i++){
+      residual[0] -= jacobian[0][i]*plan[i] + jacobian[0][N+i]*plan[N+i];
+      residual[1] -= jacobian[1][i]*plan[i] + jacobian[1][N+i]*plan[N+i];
+    }
+    // H += 2 J'QJ and g += 2 J'Q r, over the columns that are nonzero so far.
+    float QJ[2][MPC_VARIABLES];
+    for(int a = 0; a < 2; a++){
+      for(int i = 0; i < n; i++){ QJ[a][i] = Q[a][0]*jacobian[0][i] + Q[a][1]*jacobian[1][i]; }
+    }
+    for(int i = 0; i < n; i++){
+      if(jacobian[0][i] == 0 && jacobian[1][i] == 0){ continue; }
+      for(int j = 0; j < n; j++){
+        hessian[i*n+j] += 2*(jacobian[0][i]*QJ[0][j] + jacobian[1][i]*QJ[1][j]);
+      }
+      gradient[i] += 2*(QJ[0][i]*residual[0] + QJ[1][i]*residual[1]);
+    }
+  }
+
+  // Heading after each step is linear in w, so its cost is exact. It fades in near the target so that
+  // far away the robot drives to the approach line instead of turning to the final heading first.
+  if(use_angle){
+    float start_error = to_rad(reduce_negative_180_to_180(heading_deg - target_angle_deg));
+    float distance = hypot(target_X - X_position, target_Y - Y_position);
+    float weight = heading_weight/(1 + (distance*distance)/(heading_blend_distance*heading_blend_distance));
+    for(int i = 0; i < N; i++){
+      for(int j = 0; j < N; j++){
+        // Heading after step m depends on w_i and w_j for every m past both of them.
+        int stages = N - std::max(i, j);
+        hessian[(N+i)*n+N+j] += 2*weight*turn_scale*turn_scale*stages;
+      }
+      gradient[N+i] += 2*weight*turn_scale*start_error*(N - i);
+    }
+  }
+
+  // Turn effort, and smoothing between steps (the first step against the current wheel speeds).
+  float previous_v = (left_speed+right_speed)/2;
+  float previous_w = (left_speed-right_speed)/2;
+  for(int k = 0; k < N; k++){
+    hessian[(N+k)*n+N+k] += 2*turn_weight;
+    for(int offset = 0; offset < n; offset += N){
+      int i = offset+k;
+      hessian[i*n+i] += 2*smoothing_weight;
+      if(k > 0){
+        hessian[(i-1)*n+i-1] += 2*smoothing_weight;
+        hessian[i*n+i-1] -= 2*smoothing_weight;
+        hessian[(i-1)*n+i] -= 2*smoothing_weight;
+      } else {
+        gradient[i] -= 2*smoothing_weight*(offset == 0 ? previous_v : previous_w);
+      }
+    }
+  }
+
+  float change_limit = max_wheel_accel*dt;
+  for(int k = 0; k < N; k++){
+    lower_bounds[4*k] = -speed_limit; upper_bounds[4*k] = speed_limit;
+    lower_bounds[4*k+1] = -speed_limit; upper_bounds[4*k+1] = speed_limit;
+    float left_offset = (k == 0) ? left_speed : 0;
+    float right_offset = (k == 0) ? right_speed : 0;
+    lower_bounds[4*k+2] = left_offset - change_limit; upper_bounds[4*k+2] = left_offset + change_limit;
+    lower_bounds[4*k+3] = right_offset - change_limit; upper_bounds[4*k+3] = right_offset + change_limit;
+  }
+
+  qp_solve(n, MPC_CONSTRAINTS, hessian, gradient, constraint_rows, constraint_columns, constraint_values, lower_bounds, upper_bounds, plan, solver_iterations, qp_work);
+
+  // Ramp the wheels toward the first step of the plan for one update period.
+  float tick = update_period/1000.0;
+  float tick_change = max_wheel_accel*tick;
+  float left_target = clamp(plan[0]+plan[N], -speed_limit, speed_limit);
+  float right_target = clamp(plan[0]-plan[N], -speed_limit, speed_limit);
+  float new_left = left_speed + clamp(left_target-left_speed, -tick_change, tick_change);
+  float new_right = right_speed + clamp(right_target-right_speed, -tick_change, tick_change);
+  left_accel = (new_left-left_speed)/tick;
+  right_accel = (new_right-right_speed)/tick;
+  left_speed = new_left;
+  right_speed = new_right;
+}
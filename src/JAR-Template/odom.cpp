@@ -36,15 +36,24 @@ void Odom::set_position(float X_position, float Y_position, float orientation_de
   this->SideWaysTracker_position = SidewaysTracker_position;
   this->X_position = X_position;
   this->Y_position = Y_position;
+  this->X_position_sum = X_position;
+  this->Y_position_sum = Y_position;
   this->orientation_deg = orientation_deg;
 }
 
 /**
- * Does the odometry math to update position
- * Uses the Pilons arc method outline here: https://wiki.purduesigbots.com/software/odometry
- * All the deltas are done by getting member variables and comparing them to 
- * the input. Ultimately this all works to update the public member variable
- * X_position. This function needs to be run at 200Hz or so for best results.
+ * Does the odometry math to update position.
+ * Integrates each tick as a constant-curvature arc (the SE(2) exponential
+ * map of the tracker and gyro deltas). The arc chord in robot coordinates
+ * is the tracker delta times sin(d)/d at half the heading change, plus the
+ * tracker's offset times 2sin(d). It is rotated into the field frame at the
+ * mid-tick heading. For tiny heading changes sin(d)/d is a short Taylor
+ * series, so there is no divide by a near-zero angle and no special case
+ * for exactly zero. The only trig per tick is one sin/cos pair. Position is
+ * summed in double precision, so thousands of small float deltas do not
+ * round away over a long run. X_position/Y_position are the float copies
+ * everyone reads. This function needs to be run at 200Hz or so for best
+ * results.
  * 
  * @param ForwardTracker_position Current position of the sensor in inches.
  * @param SidewaysTracker_position Current position of the sensor in inches.
@@ -57,38 +66,47 @@ void Odom::update_position(float ForwardTracker_position, float SidewaysTracker_
   float Sideways_delta = SidewaysTracker_position-this->SideWaysTracker_position;
   this->ForwardTracker_position=ForwardTracker_position;
   this->SideWaysTracker_position=SidewaysTracker_position;
-  float orientation_rad = to_rad(orientation_deg);
   float prev_orientation_rad = to_rad(this->orientation_deg);
-  float orientation_delta_rad = orientation_rad-prev_orientation_rad;
+  // Heading comes in as [0, 360), so take the short way around when it wraps.
+  float orientation_delta_rad = to_rad(reduce_negative_180_to_180(orientation_deg-this->orientation_deg));
   this->orientation_deg=orientation_deg;
 
-  float local_X_position;
-  float local_Y_position;
-
-  if (orientation_delta_rad == 0) {
-    local_X_position = Sideways_delta;
-    local_Y_position = Forward_delta;
+  float half_delta = orientation_delta_rad/2;
+  float arc_scale;  // sin(half_delta)/half_delta
+  if (fabs(half_delta) < 0.01) {
+    float half_delta_squared = half_delta*half_delta;
+    arc_scale = 1 - half_delta_squared/6*(1 - half_delta_squared/20);
   } else {
-    local_X_position = (2*sin(orientation_delta_rad/2))*((Sideways_delta/orientation_delta_rad)+SidewaysTracker_center_distance); 
-    local_Y_position = (2*sin(orientation_delta_rad/2))*((Forward_delta/orientation_delta_rad)+ForwardTracker_center_distance);
+    arc_scale = fast_sin(half_delta)/half_delta;
   }
+  float chord_scale = arc_scale*orientation_delta_rad;  // 2*sin(half_delta)
 
-  float local_polar_angle;
-  float local_polar_length;
+  float local_X_position = arc_scale*Sideways_delta + chord_scale*SidewaysTracker_center_distance;
+  float local_Y_position = arc_scale*Forward_delta + chord_scale*ForwardTracker_center_distance;
 
-  if (local_X_position == 0 && local_Y_position == 0){
-    local_polar_angle = 0;
-    local_polar_length = 0;
-  } else {
-    local_polar_angle = atan2(local_Y_position, local_X_position); 
-    local_polar_length = sqrt(pow(local_X_position, 2) + pow(local_Y_position, 2)); 
-  }
+  // Rotate into the field frame at the average heading over the tick (clockwise-positive, 0 = +Y).
+  float mid_orientation_rad = prev_orientation_rad + half_delta;
+  float sin_mid, cos_mid;
+  fast_sincos(mid_orientation_rad, sin_mid, cos_mid);
 
-  float global_polar_angle = local_polar_angle - prev_orientation_rad - (orientation_delta_rad/2);
+  X_position_sum += local_X_position*cos_mid + local_Y_position*sin_mid;
+  Y_position_sum += local_Y_position*cos_mid - local_X_position*sin_mid;
+  X_position = X_position_sum;
+  Y_position = Y_position_sum;
+}
 
-  float X_position_delta = local_polar_length*cos(global_polar_angle); 
-  float Y_position_delta = local_polar_length*sin(global_polar_angle);
+/**
+ * Shifts the position without touching the tracker or heading state.
+ * Use this for corrections from outside sensors instead of writing
+ * X_position/Y_position, which the next update would overwrite.
+ * 
+ * @param X_correction Inches to add to X_position.
+ * @param Y_correction Inches to add to Y_position.
+ */
 
-  X_position+=X_position_delta;
-  Y_position+=Y_position_delta;
-}
\ No newline at end of file
+void Odom::correct_position(float X_correction, float Y_correction){
+  X_position_sum += X_correction;
+  Y_position_sum += Y_correction;
+  X_position = X_position_sum;
+  Y_position = Y_position_sum;
+}
@@ -0,0 +1,191 @@
+#include <math.h>
+#include "JAR-Template/trajectory.h"
+
+// Only math.h and trajectory.h, so tools can build this file for a PC.
+
+/**
+ * Point on the cubic Hermite curve between two waypoints.
+ * The end tangents point along each waypoint's heading, scaled by the
+ * straight-line distance between them, which gives smooth curves
+ * without loops for reasonable waypoint spacing.
+ */
+
+static path_point hermite_point(const path_waypoint &start, const path_waypoint &end, float u){
+  float tangent_scale = hypot(end.x-start.x, end.y-start.y);
+  float start_tangent_X = tangent_scale*sin(start.heading_deg*M_PI/180.0);
+  float start_tangent_Y = tangent_scale*cos(start.heading_deg*M_PI/180.0);
+  float end_tangent_X = tangent_scale*sin(end.heading_deg*M_PI/180.0);
+  float end_tangent_Y = tangent_scale*cos(end.heading_deg*M_PI/180.0);
+  float u2 = u*u;
+  float u3 = u2*u;
+  float h00 = 2*u3 - 3*u2 + 1;
+  float h10 = u3 - 2*u2 + u;
+  float h01 = -2*u3 + 3*u2;
+  float h11 = u3 - u2;
+  path_point point;
+  point.x = h00*start.x + h10*start_tangent_X + h01*end.x + h11*end_tangent_X;
+  point.y = h00*start.y + h10*start_tangent_Y + h01*end.y + h11*end_tangent_Y;
+  return(point);
+}
+
+/**
+ * Turns waypoints into evenly spaced path points.
+ * Each pair of waypoints is joined by a cubic Hermite curve, which is
+ * walked in small steps and a point is dropped every spacing inches of
+ * arc length. The last waypoint is always the last point.
+ *
+ * @param waypoints Positions and directions of travel to pass through.
+ * @param waypoint_count Number of waypoints (at least 2).
+ * @param spacing Distance between path points in inches.
+ * @param points Output array.
+ * @param max_points Size of the output array.
+ * @return Number of points written.
+ */
+
+int sample_path(const path_waypoint *waypoints, int waypoint_count, float spacing, path_point *points, int max_points){
+  if(waypoint_count < 2 || max_points < 2){ return(0); }
+  const int steps_per_segment = 400;
+  int count = 0;
+  points[count].x = waypoints[0].x;
+  points[count].y = waypoints[0].y;
+  count++;
+  path_point previous = points[0];
+  float since_last_point = 0;
+  for(int segment = 0; segment < waypoint_count-1; segment++){
+    for(int step = 1; step <= steps_per_segment; step++){
+      path_point current = hermite_point(waypoints[segment], waypoints[segment+1], step/float(steps_per_segment));
+      since_last_point += hypot(current.x-previous.x, current.y-previous.y);
+      previous = current;
+      if(since_last_point >= spacing && count < max_points-1){
+        points[count++] = current;
+        since_last_point = 0;
+      }
+    }
+  }
+  // Put the end exactly on the last waypoint, replacing a point that landed right next to it.
+  if(since_last_point < spacing/2 && count > 1){ count--; }
+  points[count].x = waypoints[waypoint_count-1].x;
+  points[count].y = waypoints[waypoint_count-1].y;
+  return(count+1);
+}
+
+/**
+ * Signed curvature through three points (one over the radius of the
+ * circle through them), positive when the turn is clockwise.
+ */
+
+static float three_point_curvature(const path_point &a, const path_point &b, const path_point &c){
+  float cross = (b.x-a.x)*(c.y-b.y) - (b.y-a.y)*(c.x-b.x);
+  float lengths = hypot(b.x-a.x, b.y-a.y)*hypot(c.x-b.x, c.y-b.y)*hypot(c.x-a.x, c.y-a.y);
+  if(lengths < 1e-6){ return(0); }
+  return(-2*cross/lengths);
+}
+
+/**
+ * Time-parameterizes a path for the fastest traversal the robot can track.
+ * Each point gets a speed cap from the wheel speed limit (the outside
+ * wheel goes faster on a curve) and the centripetal limit. A forward
+ * pass then limits how fast the robot can speed up, and a backward pass
+ * how late it can start braking, both with the wheel acceleration
+ * limit. The result is the largest speed at every point that satisfies
+ * all of them, which is the minimum-time profile. Time is integrated
+ * assuming constant acceleration between points.
+ *
+ * @param points Path points, about evenly spaced (see sample_path()).
+ * @param point_count Number of points.
+ * @param constraints Robot limits and the start and end speeds.
+ * @param trajectory Output array, point_count long.
+ * @return Number of trajectory points written (point_count, or 0 if the path is too short).
+ */
+
+int plan_trajectory(const path_point *points, int point_count, const trajectory_constraints &constraints, trajectory_point *trajectory){
+  if(point_count < 2){ return(0); }
+  float half_track = constraints.track_width/2;
+
+  for(int i = 0; i < point_count; i++){
+    trajectory_point &point = trajectory[i];
+    point.x = points[i].x;
+    point.y = points[i].y;
+    int before = (i > 0) ? i-1 : i;
+    int after = (i < point_count-1) ? i+1 : i;
+    point.heading_deg = atan2(points[after].x-points[before].x, points[after].y-points[before].y)*180.0/M_PI;
+    if(point.heading_deg < 0){ point.heading_deg += 360; }
+    point.curvature = (i > 0 && i < point_count-1) ? three_point_curvature(points[i-1], points[i], points[i+1]) : 0;
+    point.distance = (i == 0) ? 0 : trajectory[i-1].distance + hypot(points[i].x-points[i-1].x, points[i].y-points[i-1].y);
+
+    float turn_ratio = 1 + fabs(point.curvature)*half_track;
+    point.velocity = constraints.max_wheel_speed/turn_ratio;
+    if(constraints.max_centripetal_accel > 0 && fabs(point.curvature) > 1e-6){
+      point.velocity = fmin(point.velocity, sqrt(constraints.max_centripetal_accel/fabs(point.curvature)));
+    }
+  }
+  trajectory[0].velocity = fmin(trajectory[0].velocity, constraints.start_velocity);
+  trajectory[point_count-1].velocity = fmin(trajectory[point_count-1].velocity, constraints.end_velocity);
+
+  // The path acceleration the wheels allow is smaller on a curve, for the same reason as the speed.
+  for(int i = 1; i < point_count; i++){
+    float step = trajectory[i].distance - trajectory[i-1].distance;
+    float accel = constraints.max_wheel_accel/(1 + fabs(trajectory[i-1].curvature)*half_track);
+    trajectory[i].velocity = fmin(trajectory[i].velocity, sqrt(trajectory[i-1].velocity*trajectory[i-1].velocity + 2*accel*step));
+  }
+  for(int i = point_count-2; i >= 0; i--){
+    float step = trajectory[i+1].distance - trajectory[i].distance;
+    float accel = constraints.max_wheel_accel/(1 + fabs(trajectory[i+1].curvature)*half_track);
+    trajectory[i].velocity = fmin(trajectory[i].velocity, sqrt(trajectory[i+1].velocity*trajectory[i+1].velocity + 2*accel*step));
+  }
+
+  trajectory[0].time = 0;
+  for(int i = 0; i < point_count; i++){
+    trajectory[i].acceleration = 0;
+    if(i == 0){ continue; }
+    float step = trajectory[i].distance - trajectory[i-1].distance;
+    float average_velocity = (trajectory[i].velocity + trajectory[i-1].velocity)/2;
+    trajectory[i].time = trajectory[i-1].time + (average_velocity > 1e-6 ? step/average_velocity : 0);
+    if(step > 1e-6){
+      trajectory[i-1].acceleration = (trajectory[i].velocity*trajectory[i].velocity - trajectory[i-1].velocity*trajectory[i-1].velocity)/(2*step);
+    }
+  }
+  return(point_count);
+}
+
+/**
+ * Where the robot should be at a given time.
+ * Binary searches for the pair of points around the time and
+ * interpolates between them. Times before the start or after the end
+ * give the first or last point.
+ *
+ * @param trajectory Planned trajectory.
+ * @param point_count Number of points.
+ * @param time Seconds from the start.
+ * @return Interpolated trajectory point.
+ */
+
+trajectory_point sample_trajectory(const trajectory_point *trajectory, int point_count, float time){
+  if(time <= trajectory[0].time){ return(trajectory[0]); }
+  if(time >= trajectory[point_count-1].time){ return(trajectory[point_count-1]); }
+  int low = 0;
+  int high = point_count-1;
+  while(high - low > 1){
+    int middle = (low + high)/2;
+    if(trajectory[middle].time <= time){ low = middle; }
+    else { high = middle; }
+  }
+  const trajectory_point &a = trajectory[low];
+  const trajectory_point &b = trajectory[high];
+  float span = b.time - a.time;
+  float t = (span > 1e-6) ? (time - a.time)/span : 0;
+  float heading_change = b.heading_deg - a.heading_deg;
+  if(heading_change > 180){ heading_change -= 360; }
+  if(heading_change < -180){ heading_change += 360; }
+
+  trajectory_point point;
+  point.time = time;
+  point.distance = a.distance + t*(b.distance - a.distance);
+  point.x = a.x + t*(b.x - a.x);
+  point.y = a.y + t*(b.y - a.y);
+  point.heading_deg = a.heading_deg + t*heading_change;
+  point.curvature = a.curvature + t*(b.curvature - a.curvature);
+  point.velocity = a.velocity + t*(b.velocity - a.velocity);
+  point.acceleration = a.acceleration;
+  return(point);
+}
@@ -2,17 +2,14 @@
 
 /**
  * Converts an angle to an equivalent one in the range [0, 360).
+ * Constant time, so a gyro that has turned many times costs the same.
  * 
  * @param angle The angle to be reduced in degrees.
  * @return Reduced angle.
  */
 
 float reduce_0_to_360(float angle) {
-  while(!(angle >= 0 && angle < 360)) {
-    if( angle < 0 ) { angle += 360; }
-    if(angle >= 360) { angle -= 360; }
-  }
-  return(angle);
+  return(wrap_angle(angle, 0, 360));
 }
 
 /**
@@ -23,11 +20,7 @@ float reduce_0_to_360(float angle) {
  */
 
 float reduce_negative_180_to_180(float angle) {
-  while(!(angle >= -180 && angle < 180)) {
-    if( angle < -180 ) { angle += 360; }
-    if(angle >= 180) { angle -= 360; }
-  }
-  return(angle);
+  return(wrap_angle(angle, -180, 360));
 }
 
 /**
@@ -40,11 +33,7 @@ float reduce_negative_180_to_180(float angle) {
  */
 
 float reduce_negative_90_to_90(float angle) {
-  while(!(angle >= -90 && angle < 90)) {
-    if( angle < -90 ) { angle += 180; }
-    if(angle >= 90) { angle -= 180; }
-  }
-  return(angle);
+  return(wrap_angle(angle, -90, 180));
 }
 
 /**
@@ -143,6 +132,34 @@ float deadband(float input, float width){
   return(input);
 }
 
+/**
+ * Exponential joystick curve. Small stick movements give much smaller
+ * outputs for fine control, while full stick still gives full output.
+ * A curve_gain of 0 is linear; bigger values bend the curve more.
+ * 
+ * @param input The joystick value in percent.
+ * @param curve_gain How strongly to bend the curve.
+ * @return The curved value in percent.
+ */
+
+float exponential_curve(float input, float curve_gain){
+  float t = curve_gain/10.0;
+  return( (exp(-t) + exp((std::fabs(input)-100.0)/10.0)*(1.0-exp(-t))) * input );
+}
+
+/**
+ * Cubic joystick curve, a blend of a linear and a cubic response.
+ * A weight of 0 is linear and a weight of 1 is a pure cubic.
+ * 
+ * @param input The joystick value in percent.
+ * @param weight Fraction of the output taken from the cubic term.
+ * @return The curved value in percent.
+ */
+
+float cubic_curve(float input, float weight){
+  return( weight*input*input*input/10000.0 + (1.0-weight)*input );
+}
+
 /**
  * Settling control for odometry functions.
  * Draws a line perpendicular to the line from the robot to the desired 
@@ -158,7 +175,9 @@ float deadband(float input, float width){
  */
 
 bool is_line_settled(float desired_X, float desired_Y, float desired_angle_deg, float current_X, float current_Y){
-  return( (desired_Y-current_Y) * cos(to_rad(desired_angle_deg)) <= -(desired_X-current_X) * sin(to_rad(desired_angle_deg)) );
+  float sin_angle, cos_angle;
+  fast_sincos_deg(desired_angle_deg, sin_angle, cos_angle);
+  return( (desired_Y-current_Y) * cos_angle <= -(desired_X-current_X) * sin_angle );
 }
 
 /**
@@ -216,4 +235,53 @@ float clamp_min_voltage(float drive_output, float drive_min_voltage){
     return drive_min_voltage;
   }
   return drive_output;
-}
\ No newline at end of file
+}
+
+/**
+ * Samples a trapezoidal motion profile that starts and ends at rest.
+ * Accelerates at max_acceleration up to max_velocity, cruises, then
+ * decelerates to stop exactly at distance. Short moves that never
+ * reach max_velocity become a triangle. Works for negative distances.
+ * 
+ * @param distance Total signed distance of the move.
+ * @param max_velocity Cruise velocity (positive).
+ * @param max_acceleration Acceleration and deceleration (positive).
+ * @param time Time since the move started, in the same time unit as the velocity.
+ * @param position Output: signed distance covered at this time.
+ * @param velocity Output: signed velocity at this time.
+ * @return Whether the profile has finished at this time.
+ */
+
+bool trapezoidal_profile(float distance, float max_velocity, float max_acceleration, float time, float &position, float &velocity){
+  float direction = distance < 0 ? -1 : 1;
+  float total = fabs(distance);
+  float accel_time = max_velocity/max_acceleration;
+  float accel_distance = 0.5*max_acceleration*accel_time*accel_time;
+  if (2*accel_distance > total) {
+    accel_time = sqrt(total/max_acceleration);
+    accel_distance = total/2;
+  }
+  float peak_velocity = max_acceleration*accel_time;
+  float cruise_time = (total - 2*accel_distance)/peak_velocity;
+  float total_time = 2*accel_time + cruise_time;
+
+  if (total <= 0 || time >= total_time) {
+    position = distance;
+    velocity = 0;
+    return(true);
+  }
+  if (time < accel_time) {
+    position = 0.5*max_acceleration*time*time;
+    velocity = max_acceleration*time;
+  } else if (time < accel_time + cruise_time) {
+    position = accel_distance + peak_velocity*(time - accel_time);
+    velocity = peak_velocity;
+  } else {
+    float time_left = total_time - time;
+    position = total - 0.5*max_acceleration*time_left*time_left;
+    velocity = max_acceleration*time_left;
+  }
+  position *= direction;
+  velocity *= direction;
+  return(false);
+}
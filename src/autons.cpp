@@ -1,5 +1,6 @@
 #include "vex.h"
 #include "globals.h"
+#include "1091A_PathTables.h"
 
 using namespace vex;
 
@@ -12,19 +13,42 @@ using namespace vex;
  */
 
 void default_constants(){
+  // Gains and exit conditions come from robotConfig (SD card config.bin, or the defaults in 1091A_ConfigStore.h).
+  const RobotConfig& c = robotConfig;
   // Each constant set is in the form of (maxVoltage, kP, kI, kD, startI).
-  chassis.set_drive_constants(12, 0.95, 0.0, 5.0, 2);//1.5, 0, 10, 0);
-  chassis.set_drive_exit_conditions(0.1, 0, 3000);
+  chassis.set_drive_constants(c.drive.max_voltage, c.drive.drive.kp, c.drive.drive.ki, c.drive.drive.kd, c.drive.drive.starti);
+  chassis.set_drive_exit_conditions(c.drive.settle_error, c.drive.settle_time, c.drive.timeout);
+  chassis.drive_min_voltage = c.drive.min_voltage;
+  chassis.boomerang_lead = c.drive.lead;
+  chassis.boomerang_setback = c.drive.setback;
 
   // Each exit condition set is in the form of (settle_error, settle_time, timeout).
-  chassis.set_turn_constants(10, 0.8, 0, 0, 5);
-  chassis.set_turn_exit_conditions(1.5, 30, 2000); // Last one was 1, 300, 3000
-
-  chassis.set_heading_constants(6, .4, 0, 1, 0);
-
-  chassis.set_swing_constants(6, .3, .001, 2, 15);
-  chassis.set_swing_exit_conditions(1, 300, 3000);
-
+  chassis.set_turn_constants(c.turn.max_voltage, c.turn.gains.kp, c.turn.gains.ki, c.turn.gains.kd, c.turn.gains.starti);
+  chassis.set_turn_exit_conditions(c.turn.settle_error, c.turn.settle_time, c.turn.timeout);
+
+  chassis.set_heading_constants(c.drive.heading_max_voltage, c.drive.heading.kp, c.drive.heading.ki, c.drive.heading.kd, c.drive.heading.starti);
+  // Inner yaw rate loop for the straight drives: (deg/s per volt of turn, volts per deg/s of rate error).
+  chassis.set_heading_rate_constants(c.headingRatePerVolt, c.headingRateKp);
+
+  chassis.set_swing_constants(c.swing.max_voltage, c.swing.gains.kp, c.swing.gains.ki, c.swing.gains.kd, c.swing.gains.starti);
+  // Swings follow a profile now like turns, so they settle like turns instead of waiting out 300 msec.
+  chassis.set_swing_exit_conditions(c.swing.settle_error, c.swing.settle_time, c.swing.timeout);
+  // Swing profile is in the form of (deg/s, deg/s^2).
+  chassis.set_swing_profile_constants(c.swingMaxRate, c.swingMaxAccel);
+
+  // Driver control: deadband and turn scale (1.25 is the old divide by 0.8 for our high COG),
+  // then the (curve, gain) for the throttle and turn sticks.
+  chassis.set_driver_constants(5, 1.25);
+  chassis.set_driver_curves(EXPONENTIAL_CURVE, 5, EXPONENTIAL_CURVE, 8);
+
+  // Heading hold is in the form of (maxVoltage, kP, kD, latency in msec). Turn it on with chassis.heading_hold_enabled.
+  chassis.set_heading_hold_constants(6, 0.2, 1.0, 40);
+
+  // Drive model for the MPC odom moves: (wheel in/s at 12V, wheel in/s^2, track width in inches, volts per in/s^2).
+  // 600rpm * 0.75 on 2.75" wheels is 64.8 in/s. Set chassis.point_controller = MPC_CONTROLLER to use it.
+  chassis.set_drive_model_constants(64.8, 150, 11.5, 0.01);
+  // Trajectories: (sideways in/s^2 before sliding, RAMSETE beta in 1/in^2, RAMSETE zeta).
+  chassis.set_trajectory_constants(120, 0.0013, 0.7);
 }
 
 /**
@@ -70,11 +94,13 @@ void turn_test(){
 }
 
 /**
- * Should swing in a fun S shape.
+ * Should swing in a fun S shape: a pivot, then two 18" arcs chained
+ * into each other without stopping.
  */
 void swing_test(){
   chassis.left_swing_to_angle(90);
-  //chassis.right_swing_to_angle(0);
+  chassis.swing_arc_to_angle(0, 18, false, 5);
+  chassis.swing_arc_to_angle(90, 18);
 }
 
 /**
@@ -99,17 +125,44 @@ void full_test(){
 void odom_test(){
   odom_constants();
   chassis.set_coordinates(0, 0, 0);
+  //The dashboard shows X, Y, heading and both trackers, and the pose on its field map
   while(1){
-    Brain.Screen.clearScreen();
-    Brain.Screen.printAt(5,20, "X: %f", chassis.get_X_position());
-    Brain.Screen.printAt(5,40, "Y: %f", chassis.get_Y_position());
-    Brain.Screen.printAt(5,60, "Heading: %f", chassis.get_absolute_heading());
-    Brain.Screen.printAt(5,80, "ForwardTracker: %f", chassis.get_ForwardTracker_position());
-    Brain.Screen.printAt(5,100, "SidewaysTracker: %f", chassis.get_SidewaysTracker_position());
     task::sleep(1000);
   }
 }
 
+/**
+ * Doesn't drive the robot. Times the control math (PID, odom, voltage
+ * scaling, settling, the drive_to_pose carrot) with the microsecond timer
+ * and prints ns and cycles per call to the Brain screen and the console.
+ */
+
+void benchmark_test(){
+  KernelBenchmark results[KERNEL_BENCHMARK_COUNT];
+  runKernelBenchmarks(vex::timer::systemHighResolution, v5ClockMHz, results);
+  dashboard.paused = true;  //Keep the results on the screen until driver control
+  Brain.Screen.clearScreen();
+  Brain.Screen.setFont(fontType::mono20);
+  for(int i = 0; i < KERNEL_BENCHMARK_COUNT; i++){
+    char line[48];
+    snprintf(line, sizeof(line), "%-16s %7.1fns %5.0fcyc", results[i].name, results[i].nsPerCall, results[i].cyclesPerCall);
+    Brain.Screen.printAt(5, 20 + 20*i, line);
+    printf("%s\n", line);
+  }
+}
+
+/**
+ * Follows the S-curve from paths/test.path, which is built into a table
+ * at compile time, then drives it backwards to the start.
+ */
+
+void path_test(){
+  chassis.set_coordinates(0, 0, 0);
+  chassis.follow_trajectory(s_curve_test, s_curve_test_count, false);
+  wait(1, seconds);
+  chassis.follow_trajectory(s_curve_test_reversed, s_curve_test_reversed_count, true);
+}
+
 /**
  * Should end in the same place it began, but the second movement
  * will be curved while the first is straight.
@@ -141,99 +194,103 @@ void holonomic_odom_test(){
 
 
 /* ********************************* */
-/* Bunch of pre-tuned turn functions */
+/* Bunch of turn preset functions    */
 /* ********************************* */
+/* All presets use the turn engine in Drive::turn_to_angle() (profiled, with a precision phase), so they finish
+   inside the tolerance without an adjustHeading() afterwards. The tuning is in robotConfig: compiled in from
+   1091A_MotionPresets.h, loaded from the SD card, or changed on the robot with the PID TUNER. */
+
 //Use for tiny turns (less than 30 degrees)
 /// @brief Make tiny turns.  Use for turns less than 30 degrees
 /// @param targetHeading heading that we want to end up at
-inline void turn_to_heading_tiny(float targetHeading) { chassis.turn_to_heading_1091A(targetHeading, 8.5, 1.0, 2000, 0.68, 0, 0.40, 5);}
+/// @param tolerance how close to targetHeading (in degrees) the turn has to end
+void turn_to_heading_tiny(float targetHeading, float tolerance) { chassis.turn_to_angle(targetHeading, robotConfig.turnPresets[TURN_PRESET_TINY].with_settle_error(tolerance)); }
 
-/// @brief Make small turns.  Use for turns 30-60 degrees - Tuned to 45
+/// @brief Make small turns.  Use for turns 30-60 degrees
 /// @param targetHeading heading that we want to end up at
-inline void turn_to_heading_small(float targetHeading) { chassis.turn_to_heading_1091A(targetHeading, 10.0, 1.0, 2000, 0.68, 0, 0.4, 5);}
+/// @param tolerance how close to targetHeading (in degrees) the turn has to end
+void turn_to_heading_small(float targetHeading, float tolerance) { chassis.turn_to_angle(targetHeading, robotConfig.turnPresets[TURN_PRESET_SMALL].with_settle_error(tolerance)); }
 
-/// @brief Make medium turns.  Use for turns 60-120 degrees - tuned to 90
+/// @brief Make medium turns.  Use for turns 60-120 degrees
 /// @param targetHeading heading that we want to end up at
-inline void turn_to_heading_medium(float targetHeading) {chassis.turn_to_heading_1091A(targetHeading, 12, 1.0, 2000, 0.75, 0.05, 0.80, 5); }
+/// @param tolerance how close to targetHeading (in degrees) the turn has to end
+void turn_to_heading_medium(float targetHeading, float tolerance) { chassis.turn_to_angle(targetHeading, robotConfig.turnPresets[TURN_PRESET_MEDIUM].with_settle_error(tolerance)); }
 
 /// @brief Make large turns 120-150 degrees
 /// @param targetHeading heading that we want to end up at
-inline void turn_to_heading_large(float targetHeading) { chassis.turn_to_heading_1091A(targetHeading, 12, 1.0, 2000, 0.90, 0.05, 0.85, 5); }
+/// @param tolerance how close to targetHeading (in degrees) the turn has to end
+void turn_to_heading_large(float targetHeading, float tolerance) { chassis.turn_to_angle(targetHeading, robotConfig.turnPresets[TURN_PRESET_LARGE].with_settle_error(tolerance)); }
 
 /// @brief Make large turns >= 150 degrees
 /// @param targetHeading heading that we want to end up at
-inline void turn_to_heading_xlarge(float targetHeading) { chassis.turn_to_heading_1091A(targetHeading, 12, 1.0, 2000, 1.0, 0.05, 0.85, 5); }
+/// @param tolerance how close to targetHeading (in degrees) the turn has to end
+void turn_to_heading_xlarge(float targetHeading, float tolerance) { chassis.turn_to_angle(targetHeading, robotConfig.turnPresets[TURN_PRESET_XLARGE].with_settle_error(tolerance)); }
 
 
-/// @brief adjust the heading after a turn.  Use after calling one of the turn functions when we need precise turns
+/// @brief adjust the heading after a turn.  The turn presets already finish inside their tolerance, so this is only
+/// @brief needed after something that knocks the robot off its heading.  It is a short, low voltage turn_to_angle()
 /// @param targetHeading heading that we want to end up at
 /// @param tolerance How much error in the final heading we will accept
 /// @param timeout timeout for the function in milliseconds
 void adjustHeading(double targetHeading, double tolerance, double timeout) {
-  float startingHeading = chassis.Gyro.heading();
-
-  bool isTargetLTCurrent = targetHeading < startingHeading;
-  bool isTurnLeft = false;
-
-  //Figure out how many degrees to turn
-  float degreesToTurn = fabs((startingHeading - targetHeading));
-  bool isDiffLT180 = (degreesToTurn < 180.0);
-
-  //If degrees to turn is >180, then normalize it to the opposite angle
-  if (!isDiffLT180) degreesToTurn = fabs((360.0 - degreesToTurn));
-
-  //Figure out whether to turn left or right
- /* if ((isDiffLT180 && isTargetLTCurrent) || (!isDiffLT180 && !isTargetLTCurrent)) isTurnLeft = false;  // Turn Right
-  else isTurnLeft = true; //Turn Left
-*/
-  if(isDiffLT180) {
-    if(isTargetLTCurrent) isTurnLeft = true;
-    else isTurnLeft = false;
-  }
-  else {
-    if(isTargetLTCurrent) isTurnLeft = false;
-    else isTurnLeft = true;
-  }
-  
-  degreesToTurn = degreesToTurn - tolerance;
-  if (degreesToTurn > 0.2) {
-    double ahTime = Brain.Timer.value();
-    chassis.Gyro.setRotation(0.0, degrees);
-
-    //Turn voltages are opposite of what they should be because our left and right motor configurations are reversed
-    if (isTurnLeft) chassis.drive_with_voltage(2.0, -2.0);
-    else chassis.drive_with_voltage(-2.0, 2.0);
-
-    while(((Brain.Timer.value() - ahTime)*1000 < timeout) && (fabs(chassis.Gyro.rotation(degrees)) < degreesToTurn -tolerance)) task::sleep(5);
-    chassis.drive_stop(hold);
-  }
+  chassis.turn_to_angle(targetHeading, robotConfig.turnPresets[TURN_PRESET_ADJUST_HEADING].with_exit(tolerance, robotConfig.turnPresets[TURN_PRESET_ADJUST_HEADING].settle_time, timeout));
 }
 
 /* ************************************ */
 /* Bunch of pre-tuned Driving functions */
 /* ************************************ */
-inline void drive_distance_small(float distance) {
-  chassis.drive_distance_1091A(distance, chassis.get_absolute_heading(), \
-      /* driving volts, heading volts */ 11, 11, \
-      /* tolerance, settle time, timeout */ 0.1, 20, 3000, \
-      /* Driving kp, ki, kd, driving starti */ 0.95, 0.0, 2.5, 0.25*distance, \
-      /* Heading kp, ki, kd, heading starti */ 0, 0, 0, 0);
+void drive_distance_small(float distance) {
+  chassis.drive_distance_1091A(distance, chassis.get_absolute_heading(), robotConfig.drivePresets[DRIVE_PRESET_SMALL].with_drive_starti(robotConfig.drivePresets[DRIVE_PRESET_SMALL].drive.starti*distance));
 }
 
-inline void drive_distance_medium(float distance) {
-  chassis.drive_distance_1091A(distance, chassis.get_absolute_heading(), \
-      /* driving volts, heading volts */ 12, 12, \
-      /* tolerance, settle time, timeout */ 0.1, 150, 3000, \
-      /* Driving kp, ki, kd, driving starti */ 0.95, 0.2, 1.5, 0.25*distance, \
-      /* Heading kp, ki, kd, heading starti */ 0, 0, 0, 0);
+void drive_distance_medium(float distance) {
+  chassis.drive_distance_1091A(distance, chassis.get_absolute_heading(), robotConfig.drivePresets[DRIVE_PRESET_MEDIUM].with_drive_starti(robotConfig.drivePresets[DRIVE_PRESET_MEDIUM].drive.starti*distance));
 }
 
-inline void drive_distance_large(float distance) {
-  chassis.drive_distance_1091A(distance, chassis.get_absolute_heading(), \
-      /* driving volts, heading volts */ 12, 12, \
-      /* tolerance, settle time, timeout */ 0.25, 300, 3000, \
-      /* Driving kp, ki, kd, driving starti */ 0.90, 0.0, 2.5, 0.1*distance, \
-      /* Heading kp, ki, kd, heading starti */ 0, 0, 0, 0);
+void drive_distance_large(float distance) {
+  chassis.drive_distance_1091A(distance, chassis.get_absolute_heading(), robotConfig.drivePresets[DRIVE_PRESET_LARGE].with_drive_starti(robotConfig.drivePresets[DRIVE_PRESET_LARGE].drive.starti*distance));
+}
+
+/// @brief Correct odom X/Y from the field walls while an auton has asked for it with relocalizeRequested.
+/// @brief Used to create a task object in pre_auton
+/// @return always returns zero since Vex::task class expects that
+int relocalizeTask() {
+  wall_reading_streak frontStreak, backStreak;
+  while(true) {
+    if (relocalizeRequested && auto_started && fieldPoseKnown && chassis.odom_started) {
+      chassis.relocalize_from_wall(frontDistanceSensor, robotConfig.frontSensorForwardOffset, 0, true, robotConfig.relocalizeGain, frontStreak);
+      //With a mogo clamped the back sensor sees the mogo, not the wall
+      if (!mogo.value()) chassis.relocalize_from_wall(backDistanceSensor, robotConfig.backSensorForwardOffset, 0, false, robotConfig.relocalizeGain, backStreak);
+      else backStreak.count = 0;
+    }
+    else {
+      frontStreak.count = 0;
+      backStreak.count = 0;
+    }
+    task::sleep(20);
+  }
+  return 0;
+}
+
+/* Mogo grab: back in at full speed on the back distance sensor, brake as late as we can and fire the clamp
+   just before the mogo reaches it (the clamp lead covers the piston travel and sensor lag). The numbers are in
+   robotConfig. */
+
+const double mogoLateClampMarginMM = 50.0;  //How far past the clamp point a mogo can be and still get clamped after stopping short
+
+/// @brief Back into the mogo behind the robot and clamp it
+/// @return true if the mogo got clamped, false if we stopped short (timeout or robotConfig.mogoMaxTravel) without one
+bool acquire_mogo() {
+  bool reached = chassis.back_to_contact_1091A(backDistanceSensor, mogoClampDistanceMM, robotConfig.mogoClampLeadMSec, \
+      robotConfig.mogoApproachVoltage, robotConfig.mogoBrakingDecel, robotConfig.mogoApproachTimeout, robotConfig.mogoMaxTravel, clampMogo);
+  if (reached) return true;
+
+  //Stopped short: still clamp a mogo that is right behind us, but never fire on a sensor that sees nothing
+  if (backDistanceSensor.objectDistance(mm) <= mogoClampDistanceMM + mogoLateClampMarginMM) {
+    clampMogo();
+    return true;
+  }
+  return false;
 }
 
 /// @brief Spin arm up for touching the ladder.  Used to create a task object so that we can do this in parallel with other things
@@ -277,74 +334,38 @@ void run_selected_auto()
   auto_started = true;
   printAutonMode();
 
-  switch(current_auton_selection) {
-    case 0:
-      rejectRedRings=false;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      skills_auto();
-      break;
-    case 1:
-      rejectRedRings=false;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      red_wp_auto(true);
-      break;
-    case 2:
-      rejectRedRings=false;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      red_right_qual_nopid_auto();
-      break;
-    case 3:
-      // Elims Red Rush
-      rejectRedRings=false;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      red_wp_auto(false);
-      break;
-    case 4:
-      rejectRedRings=true;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      blue_wp_auto(true);
-      break;
-    case 5:
-      rejectRedRings=true;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      blue_left_qual_nopid_auto();
-      break;
-    case 6:
-      // Elims Blue Rush
-      rejectRedRings=true;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      blue_wp_auto(false);
-      break;
-    case 7:
-      rejectRedRings=false;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      drive_test();
-      break;
-    case 8:
-      rejectRedRings=false;
-      //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
-      colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
-      turn_test();
-      break;
-    default:
-      //Do Nothing
-      break;
+  if (current_auton_selection >= 0 && current_auton_selection < autonCount) {
+    const AutonDescriptor& selected = autonRegistry[current_auton_selection];
+    switch (selected.alliance) {
+      case ALLIANCE_NONE:
+      case ALLIANCE_RED: rejectRedRings = false; break;
+      case ALLIANCE_BLUE: rejectRedRings = true; break;
+      case ALLIANCE_FROM_SCRIPT: rejectRedRings = autonScript.rejectRedRings; break;
+    }
+    //Register the colorSorting Task, but only after setting the "rejectRedRings" boolean correctly
+    colorSortingTask = vex::task(ringSortingAutonTask, vex::task::taskPriorityNormal);
+    selected.entry();
   }
   colorSortingTask.stop();
   auto_started = false;
-  Brain.Screen.setFont(fontType::mono20);
-  Brain.Screen.printAt(5, 120, "TotalTme: %.3f", Brain.Timer.value() - autonStartTime);
+  float totalSeconds = Brain.Timer.value() - autonStartTime;
+  if (current_auton_selection >= 0 && current_auton_selection < autonCount) {
+    dashboard.setText(DASH_AUTON_TIME, "Auton %.3fs (exp %.1fs)", totalSeconds, autonRegistry[current_auton_selection].expectedSeconds);
+  } else {
+    dashboard.setText(DASH_AUTON_TIME, "Auton %.3fs", totalSeconds);
+  }
 }
 
-void setup_auto() {
+/* Field coordinates are in inches from the field center, and every auton starts at heading 0.
+   Red's alliance stake is on the -X wall and Blue's on the +X wall. The WP autos drive back 11.3",
+   turn side-on and back into their stake, so they start 11.3" up-field of the stake, about
+   robotConfig.allianceStakeBackedUpX from the center (back sensor 63mm off the stake; re-measure if the robot changes). */
+
+/// @brief Set up mechanisms and zero the gyro at the start of an auto
+/// @param start_X field X of the robot at the start, if known
+/// @param start_Y field Y of the robot at the start, if known
+/// @param isStartKnown whether start_X/start_Y are a real field position (driver assists that need the field pose check this)
+void setup_auto(float start_X, float start_Y, bool isStartKnown) {
   conveyor.setVelocity(100,percent);
   conveyor.setMaxTorque(100,percent);
   conveyor.setStopping(coast);
@@ -353,9 +374,15 @@ void setup_auto() {
   intake.setStopping(coast);
   arm.setVelocity(100, percent);
   arm.setMaxTorque(100,percent);
-  chassis.set_heading(0.0);
   chassis.Gyro.resetHeading();
   chassis.Gyro.resetRotation();
+  chassis.set_coordinates(start_X, start_Y, 0.0);
+  fieldPoseKnown = isStartKnown;
+  relocalizeRequested = false;  //Off until the routine asks for it
+}
+
+void setup_auto() {
+  setup_auto(0.0, 0.0, false);
 }
 
 /// @brief Shoot the ring on alliance stake
@@ -495,10 +522,9 @@ chassis.drive_distance(38.5);
 wait(0.2,seconds);
 chassis.drive_max_voltage=4.5;
 chassis.drive_distance(7.5);
-turn_to_heading_medium(270);
+turn_to_heading_medium(270, 0.5);
 intakeAndConveyor.stop(coast);
 wait(250,msec);
-adjustHeading(270,0.5,100);
 spinArmUpForLadder();
 wait(100,msec);
 chassis.drive_distance(-5);
@@ -603,43 +629,44 @@ chassis.drive_max_voltage=9;
 }
 
 /* -------------------------------------------------------------------------------------------------------------------------- */
-/// @brief Red Win Point Auto (Red - left side).  Scores 1 ring on alliance stake, 3 rings on Mogo, and touches ladder
-/// @param doLaddderDrive Whether to do the drive to the ladder ot not.  True = Do the drive, False = don't
-void red_wp_auto(bool doLadderDrive) {
-  setup_auto();
+/* Red Win Point Auto (Red - left side).  Scores 1 ring on alliance stake, 3 rings on Mogo, and touches ladder.               */
+/* Split into steps so the executor can drop the optional ones when we are behind (see 1091A_AutonExecutor.h).              */
+/* Points: 1 per ring on the mogo; the ladder touch is weighted higher since the win point needs it.                          */
 
+/// @brief Back into the alliance stake and score the preload on it
+static void red_wp_alliance_stake() {
   //Drive back and point towards alliance stake
   chassis.drive_max_voltage = 9.0;
   chassis.drive_distance(-11.30);   //Drive back (was 11.30)
-  turn_to_heading_medium(90.0); //Turn so back of robot is parallel with alliance stake wall (was 87.5) 
-  task::sleep(250); //let gyro settle
-  if(chassis.Gyro.heading() < 89 || chassis.Gyro.heading() > 91) adjustHeading(90.0, 0.5, 150);  //adjust heading to be as close to 90 as possible (this is a critical turn)
+  turn_to_heading_medium(90.0, 0.5); //Turn so back of robot is parallel with alliance stake wall (critical turn, so tight tolerance)
  
-  //Now drive backwards to Alliance stake
-  chassis.drive_with_voltage(-2.5, -2.5);
-  //task::sleep(600);
-  while(backDistanceSensor.objectDistance(distanceUnits::mm)>63) task::sleep(5);
+  //Now drive backwards to Alliance stake, stopping as soon as the back sensor is at the stake
+  chassis.stop_on_distance(backDistanceSensor, 63);
+  chassis.drive_until_contact(-2.5, 1500);
   chassis.drive_stop(hold);
   //task::sleep(10);
   
   // Now Shoot the preload ring onto alliance stake
   shoot_alliance_ring();
+}
 
+/// @brief Drive to the mogo, clamp it and start the intake
+static void red_wp_mogo() {
   //Now drive forward and tun towards the mogo
   chassis.drive_max_voltage = 12.0; //first drive straight towads the ladder
   chassis.drive_distance(20.0); //was 20
   turn_to_heading_large(215); //Then turn towads the mogo (was 215)
 
-  //Now drive to the mogo and clamp it (Total distance to mogo = 15-16"")
-  chassis.drive_distance(-15);  //fast in initial art of drive, then slow (was -14)
-  chassis.drive_max_voltage = 6;  //slow down in the last part of the mogo drive (was 3.5, then 4.0 [when distance was -12])
-  chassis.drive_distance(-18); //was -12 @ 4.0v, then -15 @ 5v, then -18 @6v
-  clampMogo();
+  //Now back into the mogo and clamp it (was drive_distance(-15) fast, then -18 at 6v, then clamp)
+  acquire_mogo();
   task::sleep(50);  //Wait a bit to let the mogo settle
 
   //Start intake and conveyor
   intakeAndConveyor.spin(fwd);
+}
 
+/// @brief Get the ring next to the neutral zone line that is closer to the ladder
+static void red_wp_first_neutral_ring() {
   //Now turn towards Neutral zone line and get a ring (the one closer to the ladder)
   //This is a 2 step turn to force a left turn
   turn_to_heading_large(90.0);
@@ -649,80 +676,100 @@ void red_wp_auto(bool doLadderDrive) {
   chassis.drive_max_voltage = 12.0; //speed up again
   chassis.drive_distance(15.0); //Was 22.25
   task::sleep(500); //wait a bit for intake to suck the ring and score it befoe doing the next thing (was 800; then 650) 
-  
-  //Get alliance side ring 
+}
+
+/// @brief Get the alliance side ring
+static void red_wp_alliance_ring() {
   chassis.drive_distance(-9); //Drive back a bit (was -9)
   turn_to_heading_small(342.5); //turn towards alliance side ring (was 337.5)
   chassis.drive_distance(13.0); //Drive to alliance side ring (was 12)
   task::sleep(300); //wait a bit for intake to suck the ring and score it befoe doing the next thing (was 250, then 250) 
+}
 
-  //Get 2nd ring next to the neutral zone
+/// @brief Get the 2nd ring next to the neutral zone (starts from where the alliance ring step ends)
+static void red_wp_second_neutral_ring() {
   turn_to_heading_small(55); //Turn toards ring (was 55)
   chassis.drive_distance(13.0); //Drive to ring (was 13; then 12.25)
   task::sleep(500); //wait a bit for intake to suck the ring and score it befoe doing the next thing (was was  500; then 500)
   chassis.drive_with_voltage(-12, -12); //Now drive back a bit so we do not cross the line when turning towards ladder
   task::sleep(225);
   chassis.drive_stop(brake);
+}
+
+/// @brief Turn to the ladder and start the curve drive into it (the drive keeps going until auton ends)
+static void red_wp_ladder() {
+  //Turn towards the ladder
+  turn_to_heading_large(180);
+  //Raise arm on a separate thread while driving 
+  vex::task armTask(spinArmUpForLadder, vex::task::taskPriorityNormal);
+  //Do a curve drive to the ladder
+  chassis.drive_stop(coast);  //This sets the chassis stop mode to coast as a safety net
+  chassis.drive_with_voltage(5.5, 2.95); //Do a curve drive so we get more parallel to the ladder as we drive (was 4.75, 2.55)
+}
+
+static const AutonStep redWinPointSteps[] = {
+  {"alliance stake", red_wp_alliance_stake, 3.2, 0, false},
+  {"mogo", red_wp_mogo, 2.6, 0, false},
+  {"neutral ring 1", red_wp_first_neutral_ring, 2.0, 0, false},
+  {"alliance ring", red_wp_alliance_ring, 1.7, 1, false},
+  {"neutral ring 2", red_wp_second_neutral_ring, 1.6, 1, true},
+  {"ladder", red_wp_ladder, 1.0, 4, false},  //Must stay last: it is left off in elims
+};
+
+/// @param doLaddderDriveWhether to do the drive to the ladder ot not.  True = Do the drive, False = don't
+void red_wp_auto(bool doLadderDrive) {
+  setup_auto(-robotConfig.allianceStakeBackedUpX, robotConfig.wpStartY, true);
+  relocalizeRequested = true;
 
   //In Elims, do not run code to touch ladder; otherwise go touch the ladder
-  if(doLadderDrive) {
-    //Turn towards the ladder
-    turn_to_heading_large(180);
-    //Raise arm on a separate thread while driving 
-    vex::task armTask(spinArmUpForLadder, vex::task::taskPriorityNormal);
-    //Do a curve drive to the ladder
-    chassis.drive_stop(coast);  //This sets the chassis stop mode to coast as a safety net
-    chassis.drive_with_voltage(5.5, 2.95); //Do a curve drive so we get more parallel to the ladder as we drive (was 4.75, 2.55)
-  }
+  int stepCount = sizeof(redWinPointSteps)/sizeof(redWinPointSteps[0]);
+  runAutonSteps("red_wp.tim", redWinPointSteps, stepCount, doLadderDrive ? stepCount : stepCount - 1, 15.0);
 
   //Wait till we run out of time, then stop
-  while((Brain.Timer.value() - autonStartTime) < 15.0) {
-    //Do Nothing
-    task::sleep(5);
-  }
+  waitForAutonEnd(15.0);
   //Stop intake and conveyor
   intakeAndConveyor.stop(brakeType::coast);
   chassis.drive_stop(coast);  
 }
 
 /* -------------------------------------------------------------------------------------------------------------------------- */
-/// @brief Blue side Win Point Auto (BLUE - Right side).  Scores 1 ring on alliance stake, 3 rings on Mogo, and touches ladder'
-/// @param doLaddderDriveWhether to do the drive to the ladder ot not.  True = Do the drive, False = don't
-void blue_wp_auto(bool doLadderDrive) {
-  setup_auto();
+/* Blue side Win Point Auto (BLUE - Right side).  Scores 1 ring on alliance stake, 3 rings on Mogo, and touches ladder.       */
+/* Same steps and points as the red one.                                                                                       */
 
+/// @brief Back into the alliance stake and score the preload on it
+static void blue_wp_alliance_stake() {
   //Drive back and point towards alliance stake
   chassis.drive_max_voltage = 9.0;
   chassis.drive_distance(-11.30);   //Drive back (was 11.30)
-  turn_to_heading_medium(270.0); //Turn so back of robot is parallel with alliance stake wall (was 87.5) 
-  task::sleep(250); //let gyro settle
-  if(chassis.Gyro.heading() < 269 || chassis.Gyro.heading() > 271) adjustHeading(270, 0.5, 150);  //adjust heading to be as close to 90 as possible (this is a critical turn)
+  turn_to_heading_medium(270.0, 0.5); //Turn so back of robot is parallel with alliance stake wall (critical turn, so tight tolerance)
  
-  //Now drive backwards to Alliance stake
-  chassis.drive_with_voltage(-2.5, -2.5);
-  //task::sleep(600);
-  while(backDistanceSensor.objectDistance(distanceUnits::mm)>63) task::sleep(5);
+  //Now drive backwards to Alliance stake, stopping as soon as the back sensor is at the stake
+  chassis.stop_on_distance(backDistanceSensor, 63);
+  chassis.drive_until_contact(-2.5, 1500);
   chassis.drive_stop(hold);
   //task::sleep(10);
   
   // Now Shoot the preload ring onto alliance stake
   shoot_alliance_ring();
+}
 
+/// @brief Drive to the mogo, clamp it and start the intake
+static void blue_wp_mogo() {
   //Now drive forward and tun towards the mogo
   chassis.drive_max_voltage = 12.0; //first drive straight towads the ladder
   chassis.drive_distance(20.0); //was 20
   turn_to_heading_large(145); //reverse of red (360-215=145)
 
-  //Now drive to the mogo and clamp it (Total distance to mogo = 15-16"")
-  chassis.drive_distance(-15);  //fast in initial art of drive, then slow (was -14)
-  chassis.drive_max_voltage = 6;  //slow down in the last part of the mogo drive (was 3.5, then 4.0 [when distance was -12])
-  chassis.drive_distance(-18); //was -12 @ 4.0v, then -15 @ 5v, then -18 @6v
-  clampMogo();
+  //Now back into the mogo and clamp it (was drive_distance(-15) fast, then -18 at 6v, then clamp)
+  acquire_mogo();
   task::sleep(50);  //Wait a bit to let the mogo settle
 
   //Start intake and conveyor
   intakeAndConveyor.spin(fwd);
+}
 
+/// @brief Get the ring next to the neutral zone line that is closer to the ladder
+static void blue_wp_first_neutral_ring() {
   //Now turn towards Neutral zone line and get a ring (the one closer to the ladder)
   //This is a 2 step turn to force a left turn
   turn_to_heading_large(270.0); //Reverse of red (360-90 = 270)
@@ -731,38 +778,57 @@ void blue_wp_auto(bool doLadderDrive) {
   chassis.drive_max_voltage = 12.0; //speed up again
   chassis.drive_distance(19.0); //Was 15.5
   task::sleep(500); //wait a bit for intake to suck the ring and score it befoe doing the next thing (was 800; then 650) 
-  
-  //Get alliance side ring 
+}
+
+/// @brief Get the alliance side ring
+static void blue_wp_alliance_ring() {
   chassis.drive_distance(-11.5); //Drive back a bit (was -9)
   turn_to_heading_small(15); //turn towards alliance side ring
   chassis.drive_distance(13.0); //Drive to alliance side ring (was 12)
   task::sleep(250); //wait a bit for intake to suck the ring and score it befoe doing the next thing (was 250, then 250) 
+}
 
-  //Get 2nd ring next to the neutral zone
+/// @brief Get the 2nd ring next to the neutral zone (starts from where the alliance ring step ends)
+static void blue_wp_second_neutral_ring() {
   turn_to_heading_small(300); //Turn toards ring
   chassis.drive_distance(14); //Drive to ring
   task::sleep(450); //wait a bit for intake to suck the ring and score it befoe doing the next thing (was was  500; then 500)
   chassis.drive_with_voltage(-12, -12); //Now drive back a bit so we do not cross the line when turning towards ladder
   task::sleep(200); //was 225  
   chassis.drive_stop(brake);
-  
+}
+
+/// @brief Turn to the ladder and start the curve drive into it (the drive keeps going until auton ends)
+static void blue_wp_ladder() {
+  //Turn towards the ladder
+  turn_to_heading_xlarge(190); //Should be 180, but turn a bit less to save time
+  //Raise arm on a separate thread while driving 
+  vex::task armTask(spinArmUpForLadder, vex::task::taskPriorityNormal);
+  //Do a curve drive to the ladder
+  chassis.drive_stop(coast);  //This sets the chassis stop mode to coast as a safety net
+  chassis.drive_with_voltage(3.0, 5.75); //Do a curve drive so we get more parallel to the ladder as we drive (was 4.75, 2.55)
+}
+
+static const AutonStep blueWinPointSteps[] = {
+  {"alliance stake", blue_wp_alliance_stake, 3.2, 0, false},
+  {"mogo", blue_wp_mogo, 2.6, 0, false},
+  {"neutral ring 1", blue_wp_first_neutral_ring, 2.1, 0, false},
+  {"alliance ring", blue_wp_alliance_ring, 1.8, 1, false},
+  {"neutral ring 2", blue_wp_second_neutral_ring, 1.6, 1, true},
+  {"ladder", blue_wp_ladder, 1.2, 4, false},  //Must stay last: it is left off in elims
+};
+
+/// @param doLaddderDriveWhether to do the drive to the ladder ot not.  True = Do the drive, False = don't
+void blue_wp_auto(bool doLadderDrive) {
+  setup_auto(robotConfig.allianceStakeBackedUpX, robotConfig.wpStartY, true);
+  relocalizeRequested = true;
+
   //In Elims, do not run code to touch ladder; otherwise go touch the ladder
-  if(doLadderDrive) {
-    //All rings done, Now go touch the ladder
-    //Turn towards the ladder
-    turn_to_heading_xlarge(190); //Should be 180, but turn a bit less to save time
-    //Raise arm on a separate thread while driving 
-    vex::task armTask(spinArmUpForLadder, vex::task::taskPriorityNormal);
-    //Do a curve drive to the ladder
-    chassis.drive_stop(coast);  //This sets the chassis stop mode to coast as a safety net
-    chassis.drive_with_voltage(3.0, 5.75); //Do a curve drive so we get more parallel to the ladder as we drive (was 4.75, 2.55)
-  }
-  
+  int stepCount = sizeof(blueWinPointSteps)/sizeof(blueWinPointSteps[0]);
+  runAutonSteps("blue_wp.tim", blueWinPointSteps, stepCount, doLadderDrive ? stepCount : stepCount - 1, 15.0);
+
   //Wait till we run out of time, then stop
-  while((Brain.Timer.value() - autonStartTime) < 15.0) {
-    //Do Nothing
-    task::sleep(5);
-  }
+  waitForAutonEnd(15.0);
   //Stop intake and conveyor
   intakeAndConveyor.stop(brakeType::coast);
   chassis.drive_stop(coast);  
@@ -787,9 +853,8 @@ void red_right_qual_nopid_auto() {
   //Drive to Mogo
   chassis.drive_with_voltage(-6,-6);
   task::sleep(750);
-  chassis.drive_with_voltage(-3.5,-3.5);
-  task::sleep(950);
-  chassis.drive_stop(vex::brake);
+  chassis.stop_on_distance(backDistanceSensor, mogoClampDistanceMM);
+  chassis.drive_until_contact(-3.5, 950);  //slow in until the mogo is in the clamp
 
   //Clamp Mogo and score preload
   clampMogo();
@@ -848,9 +913,8 @@ void blue_left_qual_nopid_auto() {
   //Drive to Mogo
   chassis.drive_with_voltage(-6,-6);
   task::sleep(750);
-  chassis.drive_with_voltage(-3.5,-3.5);
-  task::sleep(950);
-  chassis.drive_stop(vex::brake);
+  chassis.stop_on_distance(backDistanceSensor, mogoClampDistanceMM);
+  chassis.drive_until_contact(-3.5, 950);  //slow in until the mogo is in the clamp
 
   //Clamp Mogo and score preload
   clampMogo();
@@ -894,4 +958,29 @@ void blue_left_qual_nopid_auto() {
   task::sleep(3000);
 
   chassis.drive_stop(coast);
-}
\ No newline at end of file
+}
+
+/* No-argument entry points for the auton table */
+void red_wp_qual_auto() {
+  red_wp_auto(true);
+}
+
+void red_wp_elims_auto() {
+  red_wp_auto(false);
+}
+
+void blue_wp_qual_auto() {
+  blue_wp_auto(true);
+}
+
+void blue_wp_elims_auto() {
+  blue_wp_auto(false);
+}
+
+void sd_script_auto() {
+  if (autonScript.loaded) runAutonScript();
+}
+
+/// @brief Auton entry for selector slots that only do something in driver control (like the PID TUNER)
+void no_auton() {
+}
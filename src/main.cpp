@@ -5,23 +5,14 @@ using namespace vex;
 competition Competition;
 
 
-/*
- 0 = Skills
- 1 = Red WP (4 Rings + Ladder)
- 2 = Red Right Side (2 ring + Ladder)
- 3 = Red ELIMS (WP w/o Ladder)
- 4 = Blue WP (4 rings + Ladder)
- 5 = Blue Left Side (2 ring + Ladder)
- 6 = Blue ELIMS (WP w/o Ladder)
- 7 = Drive Test
- 8 = Turn Test
-*/
-int current_auton_selection = 1;
-bool rejectRedRings = false;  //Set to TRUE for 4, 5, 6.  FALSE for others
+int current_auton_selection = 1;  //Index into autonRegistry (1091A_AutonRegistry.h), which lists every selectable auton
+bool rejectRedRings = false;  //Set from the selected auton's alliance when auton starts
 
 bool userControl_started = false;
 bool auto_started = false;
 double autonStartTime = 0.0;
+bool fieldPoseKnown = false;  //True once odom has been set to a real field position (by setup_auto)
+bool relocalizeRequested = false;  //Set by an auton to have relocalizeTask correct odom from the walls
 
 /*---------------------------------------------------------------------------*/
 /*                             VEXcode Config                                */
@@ -43,23 +34,45 @@ double autonStartTime = 0.0;
 /*  already have configured your motors.                                     */
 /*---------------------------------------------------------------------------*/
 
-Drive chassis(
+/*---------------------------------------------------------------------------*/
+/*                                  ODOM                                     */
+/*                                                                           */
+/*  Pick the tracking wheels your robot has. Each one is one of:             */
+/*    RotationTracker(port, diameter, center distance)                       */
+/*        rotation sensor, port in "PORT1" format                            */
+/*    EncoderTracker(port, diameter, center distance)                        */
+/*        encoder, port as an integer: Triport A is 1, Triport B is 2, etc.  */
+/*    MotorTracker(motor group, wheel diameter, external ratio, distance)    */
+/*        a side of the drive, for odom with zero trackers                   */
+/*    NoTracker()                                                            */
+/*  and both types go in the angle brackets, forward tracker first. Only the */
+/*  sensors listed here are ever set up. The old drive setups map to:        */
+/*    ZERO_TRACKER_NO_ODOM        <NoTracker, NoTracker>                     */
+/*    ZERO_TRACKER_ODOM           <MotorTracker, NoTracker>                  */
+/*    TANK_ONE_FORWARD_ROTATION   <RotationTracker, NoTracker>               */
+/*    TANK_ONE_SIDEWAYS_ROTATION  <MotorTracker, RotationTracker>            */
+/*    TANK_TWO_ROTATION           <RotationTracker, RotationTracker>         */
+/*  and the same with EncoderTracker for the encoder setups.                 */
+/*---------------------------------------------------------------------------*/
 
-//Pick your drive setup from the list below:
-//ZERO_TRACKER_NO_ODOM
-//ZERO_TRACKER_ODOM
-//TANK_ONE_FORWARD_ENCODER
-//TANK_ONE_FORWARD_ROTATION
-//TANK_ONE_SIDEWAYS_ENCODER
-//TANK_ONE_SIDEWAYS_ROTATION
-//TANK_TWO_ENCODER
-//TANK_TWO_ROTATION
-//HOLONOMIC_TWO_ENCODER
-//HOLONOMIC_TWO_ROTATION
-//
-//Write it here:
-//ZERO_TRACKER_NO_ODOM,
-TANK_TWO_ROTATION,
+TrackerOdom<RotationTracker, RotationTracker> chassisOdom(
+
+//Forward Tracker (the tracker which runs parallel to the direction of the chassis): port, diameter (reverse it to make
+//the direction switch), and center distance in inches (a positive distance corresponds to a tracker on the right side
+//of the robot, negative is left). For a MotorTracker, use the positive distance from the center of the robot to the
+//right side of the drive and the right motor group.
+RotationTracker(PORT1, 2.00, 0),
+
+//Sideways Tracker, following the same steps as the Forward Tracker (positive distance is behind the center of the
+//robot, negative is in front):
+RotationTracker(PORT10, -2.00, 5.5)
+
+);
+
+//FOR HOLONOMIC DRIVES ONLY: Input your drive motors by position, and add holonomicMotors after chassisOdom below.
+//HolonomicMotors holonomicMotors(PORT1, -PORT2, PORT3, -PORT4);  //LF, RF, LB, RB
+
+Drive chassis(
 
 //Add the names of your Drive motors into the motor groups below, separated by commas, i.e. motor_group(Motor1,Motor2,Motor3).
 //You will input whatever motor names you chose when you configured your robot using the sidebar configurer, they don't have to be "Motor1" and "Motor2".
@@ -85,127 +98,82 @@ PORT6,
 //For most cases 360 will do fine here, but this scale factor can be very helpful when precision is necessary.
 360,
 
-/*---------------------------------------------------------------------------*/
-/*                                  PAUSE!                                   */
-/*                                                                           */
-/*  The rest of the drive constructor is for robots using POSITION TRACKING. */
-/*  If you are not using position tracking, leave the rest of the values as  */
-/*  they are.                                                                */
-/*---------------------------------------------------------------------------*/
-
-//If you are using ZERO_TRACKER_ODOM, you ONLY need to adjust the FORWARD TRACKER CENTER DISTANCE.
-
-//FOR HOLONOMIC DRIVES ONLY: Input your drive motors by position. This is only necessary for holonomic drives, otherwise this section can be left alone.
-//LF:      //RF:    
-PORT1,     -PORT2,
-
-//LB:      //RB: 
-PORT3,     -PORT4,
-
-//If you are using position tracking, this is the Forward Tracker port (the tracker which runs parallel to the direction of the chassis).
-//If this is a rotation sensor, enter it in "PORT1" format, inputting the port below.
-//If this is an encoder, enter the port as an integer. Triport A will be a "1", Triport B will be a "2", etc.
-PORT1,
-
-//Input the Forward Tracker diameter (reverse it to make the direction switch):
-2.00,
-
-//Input Forward Tracker center distance (a positive distance corresponds to a tracker on the right side of the robot, negative is left.)
-//For a zero tracker tank drive with odom, put the positive distance from the center of the robot to the right side of the drive.
-//This distance is in inches:
-0,
-
-//Input the Sideways Tracker Port, following the same steps as the Forward Tracker Port:
-PORT10,
-
-//Sideways tracker diameter (reverse to make the direction switch):
--2.00,
-
-//Sideways tracker center distance (positive distance is behind the center of the robot, negative is in front):
-5.5
+//Odom source from above:
+chassisOdom
 
 );
 
+/// @brief Brain screen color for an auton table entry
+static color toScreenColor(AutonColor autonColor) {
+  switch (autonColor) {
+    case AUTON_COLOR_PURPLE: return color::purple;
+    case AUTON_COLOR_RED: return color::red;
+    case AUTON_COLOR_BLUE: return color::blue;
+    case AUTON_COLOR_GREEN: return color::green;
+    case AUTON_COLOR_ORANGE: return color::orange;
+  }
+  return color::black;
+}
+
 void printAutonMode() {
-    Brain.Screen.setFont(fontType::mono40);
-    Brain.Screen.setFillColor(color::black);
-
-    switch(current_auton_selection) {
-      case 0:
-        Brain.Screen.setFillColor(color::purple);
-        Brain.Screen.printAt(5, 200, "SKILLS        ");
-        break;
-      case 1:
-        Brain.Screen.setFillColor(color::red);
-        Brain.Screen.printAt(5, 200, "RED WIN POINT ");
-        break;
-      case 2:
-        Brain.Screen.setFillColor(color::red);
-        Brain.Screen.printAt(5, 200,"RED RIGHT QUAL ");
-        break;
-      case 3:
-        Brain.Screen.setFillColor(color::red);
-        Brain.Screen.printAt(5, 200,"ELIMS RED      ");
-        break;
-      case 4:
-        Brain.Screen.setFillColor(color::blue);
-        Brain.Screen.printAt(5, 200,"BLUE WIN POINT ");
-        break;
-      case 5:
-        Brain.Screen.setFillColor(color::blue);
-        Brain.Screen.printAt(5, 200,"BLUE LEFT QUAL ");
-        break;
-      case 6:
-        Brain.Screen.setFillColor(color::blue);
-        Brain.Screen.printAt(5, 200,"ELIMS BLUE     ");
-        break;
-      case 7:
-        Brain.Screen.setFillColor(color::green);
-        Brain.Screen.printAt(5, 200,"DRIVE TEST     ");
-        break;
-      case 8:
-        Brain.Screen.setFillColor(color::green);
-        Brain.Screen.printAt(5, 200,"TURN TEST      ");
-        break;
-      default:
-        Brain.Screen.setFillColor(color::black);
-        Brain.Screen.printAt(5, 200,"--- NO AUTO ---");
-        break;
+    if (current_auton_selection < 0 || current_auton_selection >= autonCount) {
+      dashboard.setTextColor(DASH_AUTON_LABEL, color::black);
+      dashboard.setText(DASH_AUTON_LABEL, "--- NO AUTO ---");
+      return;
+    }
+
+    const AutonDescriptor& selected = autonRegistry[current_auton_selection];
+    if (selected.alliance == ALLIANCE_FROM_SCRIPT && !autonScript.loaded) {
+      //Nothing to run; say why instead of showing the routine name
+      dashboard.setTextColor(DASH_AUTON_LABEL, color::black);
+      if (autonScript.errorLine > 0) dashboard.setText(DASH_AUTON_LABEL, "SD ERR LINE %d", autonScript.errorLine);
+      else dashboard.setText(DASH_AUTON_LABEL, "SD: NO SCRIPT");
+      return;
     }
+    dashboard.setTextColor(DASH_AUTON_LABEL, toScreenColor(selected.color));
+    dashboard.setText(DASH_AUTON_LABEL, "%s", selected.name);
 }
 
 void onAutonSelectorPressed()
 {
-  if(!auto_started) {
+  if(!auto_started && !tuningConsoleActive) {
     if(autonSelectorBumper.pressing() > 0) {
       current_auton_selection ++;
-      Brain.Screen.clearScreen();
       task::sleep(500);
     }
-    if (current_auton_selection == 9) current_auton_selection = 0;
+    if (current_auton_selection >= autonCount) current_auton_selection = 0;
     printAutonMode();
   }
 }
 
 int printSensorValues()
 {
-  Brain.Screen.clearScreen();
+  bool screenTaken = false;
   while(true) {
-    Brain.Screen.setFont(fontType::mono20);
-    Brain.Screen.setFillColor(color::black);
-    Brain.Screen.printAt(5,20,"Battery Percentage: %03d", Brain.Battery.capacity()); 
-
-    Brain.Screen.printAt(5, 40,"Chassis Heading Reading: %0.4f", chassis.Gyro.heading());
-
-    Brain.Screen.printAt(5,60,"Color reading: %04d", (int) myOptical.hue());
-
-    Brain.Screen.printAt(5,80,"Front Distance reading: %04d", (int) frontDistanceSensor.objectDistance(distanceUnits::mm));
-
-    Brain.Screen.printAt(5,100,"Back Distance reading: %04d", (int) backDistanceSensor.objectDistance(distanceUnits::mm));
-
+    //The tuning console (or a test printing results) has the screen to itself; start from a clean screen after
+    if (tuningConsoleActive || dashboard.paused) {
+      screenTaken = true;
+      task::sleep(250);
+      continue;
+    }
+    if (screenTaken) dashboard.invalidate();
+    screenTaken = false;
+
+    //Only lines that changed are drawn again, and draw() stops at its time budget
+    dashboard.setText(DASH_BATTERY, "Battery %3d%%  Draw %4dus", (int) Brain.Battery.capacity(), (int) dashboard.averageFrameMicros);
+    dashboard.setText(DASH_HEADING, "Heading %8.2f", chassis.Gyro.heading());
+    dashboard.setText(DASH_POSE, "X %7.1f  Y %7.1f", chassis.get_X_position(), chassis.get_Y_position());
+    dashboard.setText(DASH_TRACKERS, "Fwd %7.1f  Side %7.1f", chassis.get_ForwardTracker_position(), chassis.get_SidewaysTracker_position());
+    dashboard.setText(DASH_COLOR, "Hue %4d", (int) myOptical.hue());
+    dashboard.setText(DASH_DISTANCE, "Front %4d  Back %4d mm", (int) frontDistanceSensor.objectDistance(distanceUnits::mm),
+      (int) backDistanceSensor.objectDistance(distanceUnits::mm));
+    dashboard.setText(DASH_CONFIG, "Config %s %dus", robotConfigStatusText(), (int) robotConfigDecodeMicros);
+    showSelfTest(Brain.Timer.value()*1000.0);
+    dashboard.setPose(chassis.get_X_position(), chassis.get_Y_position(), chassis.get_absolute_heading());
     printAutonMode();
-    
-    task::sleep(250);
+
+    dashboard.draw(dashboardFrameBudgetMicros);
+    task::sleep(dashboardFrameMSec);
   }
   return 0;
 }
@@ -219,26 +187,27 @@ int printSensorValues()
 void pre_auton() {
   // Initializing Robot Configuration. DO NOT REMOVE!
   vexcodeInit();
+  //Gains, presets and routine offsets from the SD card (compiled-in values if there is no good file), before
+  //default_constants() hands them to the chassis
+  loadRobotConfig(ROBOT_CONFIG_FILE_NAME);
   default_constants();
 
-  Controller1.ButtonR1.pressed(clampMogo);
-  Controller1.ButtonR2.pressed(releaseMogo);
-
-  Controller1.ButtonL1.pressed(spinConveyorForward);
-  Controller1.ButtonL2.pressed(spinConveyorReverse);
-
-  Controller1.ButtonLeft.pressed(gotoReceiveRingPosition);
-  Controller1.ButtonUp.pressed(rotateArmForward);
-  Controller1.ButtonDown.pressed(rotateArmBack);
-  Controller1.ButtonRight.pressed(lockRing);
+  //Parse the SD card auton (if there is one) now, so the auton itself doesn't wait on the SD card
+  loadAutonScript("auton.txt");
 
-  Controller1.ButtonX.pressed(lowerDoinker);
-  Controller1.ButtonB.pressed(raiseDoinker);
+  //Check every sensor and motor while the robot sits still (about 1.5 sec), so a loose cable shows up before the match
+  runSelfTest();
 
   autonSelectorBumper.pressed(onAutonSelectorPressed);
 
-  //start a task to continously print sensor values on brain screen on a separate thread
+  //start a task to keep the Brain screen dashboard up to date on a separate thread
   task printSensorValuesTask = vex::task(printSensorValues, vex::task::taskPrioritylow);
+
+  //send the controller screen lines and rumbles, one per radio slot, so nothing else waits on the controller
+  task controllerFeedbackSender = vex::task(controllerFeedbackTask, vex::task::taskPrioritylow);
+
+  //keep odom honest against the field walls (does nothing until an auton sets a known field position)
+  task relocalizeOdomTask = vex::task(relocalizeTask, vex::task::taskPrioritylow);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -253,8 +222,22 @@ void pre_auton() {
 
 void usercontrol(void) {
   auto_started = false;
+  relocalizeRequested = false;
   userControl_started = true;
-  Brain.Screen.clearScreen();
+  dashboard.paused = false;  //Give the screen back to the dashboard if a test had it
+
+  //Controller is sampled once per tick and the mechanisms are driven from that snapshot
+  DriverInput driverInput;
+  DriverAssist driverAssist;
+
+  //Keep odom running for the driver assists (auton normally started it already at the real field position)
+  if (!chassis.odom_started) chassis.set_coordinates(0, 0, chassis.get_absolute_heading());
+
+  //Some selector slots (like the PID TUNER, until B is held) take over the start of driver control
+  if (current_auton_selection >= 0 && current_auton_selection < autonCount &&
+      autonRegistry[current_auton_selection].driverControl != nullptr) {
+    autonRegistry[current_auton_selection].driverControl();
+  }
 
   // User control code here, inside the loop
   while (1) {
@@ -267,12 +250,17 @@ void usercontrol(void) {
     // update your motors, etc.
     // ........................................................................
 
+    driverInput.sample(Controller1);
+
     //Replace this line with chassis.control_tank(); for tank drive 
     //or chassis.control_holonomic(); for holo drive.
-    chassis.control_arcade();
+    if (!driverAssist.update(driverInput)) chassis.control_arcade(driverInput.Axis3, driverInput.Axis1);
+
+    updateDriverSubsystems(driverInput);
 
-    wait(20, msec); // Sleep the task for a short amount of time to
-                    // prevent wasted resources.
+    wait(5, msec); // Sleep the task for a short amount of time to
+                   // prevent wasted resources. 5 msec matches the old button
+                   // loops and the odom update rate.
   }
   userControl_started = false;
 }
@@ -0,0 +1,28 @@
+/* ******************************************************************************* */
+/* PC run of the control kernel benchmarks in src/1091A_Benchmark.cpp. Build and   */
+/* run with "make bench-host". Pass the PC's clock in MHz to get cycle counts for  */
+/* it (they default to the V5 brain's clock, which is only right on the brain).    */
+/* ******************************************************************************* */
+
+#include <chrono>
+#include "vex.h"
+#include "1091A_Benchmark.h"
+
+vex::brain Brain;
+
+static uint64_t hostMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+  float clockMHz = (argc > 1) ? atof(argv[1]) : v5ClockMHz;
+
+  KernelBenchmark results[KERNEL_BENCHMARK_COUNT];
+  runKernelBenchmarks(hostMicroseconds, clockMHz, results);
+
+  printf("%-18s %10s %10s\n", "kernel", "ns/call", "cycles");
+  for (int ii = 0; ii < KERNEL_BENCHMARK_COUNT; ii++) {
+    printf("%-18s %10.1f %10.0f\n", results[ii].name, results[ii].nsPerCall, results[ii].cyclesPerCall);
+  }
+  return 0;
+}
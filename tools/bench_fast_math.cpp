@@ -0,0 +1,104 @@
+/* ******************************************************************************* */
+/* PC micro-benchmark for include/JAR-Template/fast_math.h (make bench-host). Not  */
+/* part of the robot build. Checks that the constant time angle wrap gives the     */
+/* same answers as the old loops and measures the sincos error, then times both.   */
+/* ******************************************************************************* */
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include "JAR-Template/fast_math.h"
+
+/// @brief The loop based reduce_negative_180_to_180 that util.cpp used before, kept as the reference
+static float loop_reduce_negative_180_to_180(float angle) {
+  while(!(angle >= -180 && angle < 180)) {
+    if( angle < -180 ) { angle += 360; }
+    if(angle >= 180) { angle -= 360; }
+  }
+  return(angle);
+}
+
+static const int sampleCount = 4096;
+static const int passCount = 2000;
+static float samples[sampleCount];
+volatile float sink;  //Keeps the optimizer from throwing the timed loops away
+
+/// @brief Simple LCG so every run uses the same inputs
+static float nextRandom(unsigned int& state) {
+  state = state*1664525u + 1013904223u;
+  return (state >> 8)*(1.0f/16777216.0f);
+}
+
+/// @brief Fill samples with angles spread over +/- range
+static void makeSamples(float range) {
+  unsigned int state = 1091;
+  for (int ii = 0; ii < sampleCount; ii++) samples[ii] = (2*nextRandom(state) - 1)*range;
+}
+
+/// @brief Time one kernel over every sample, passCount times
+/// @return nanoseconds per call
+template <typename Kernel>
+static double timeKernel(Kernel kernel) {
+  float total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passCount; pass++) {
+    for (int ii = 0; ii < sampleCount; ii++) total += kernel(samples[ii]);
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = total;
+  return std::chrono::duration<double, std::nano>(end - start).count()/(double(passCount)*sampleCount);
+}
+
+static int checkWrap() {
+  int mismatches = 0;
+  for (float angle = -3600; angle <= 3600; angle += 0.37f) {
+    if (wrap_angle(angle, -180, 360) != loop_reduce_negative_180_to_180(angle)) mismatches++;
+  }
+  //Edges where the divide rounds to the wrong side
+  const float edges[] = {-180.0f, 180.0f, -1e-6f, 359.99997f, -359.99997f, 1e-30f, -1e-30f};
+  for (unsigned int ii = 0; ii < sizeof(edges)/sizeof(edges[0]); ii++) {
+    float wrapped = wrap_angle(edges[ii], -180, 360);
+    if (!(wrapped >= -180 && wrapped < 180)) mismatches++;
+  }
+  return mismatches;
+}
+
+static double maxSincosErrorDeg(float range) {
+  double worst = 0;
+  for (float angle = -range; angle <= range; angle += range/200000) {
+    float s, c;
+    fast_sincos_deg(angle, s, c);
+    double exact = angle*M_PI/180.0;
+    worst = fmax(worst, fmax(fabs(s - sin(exact)), fabs(c - cos(exact))));
+  }
+  return worst;
+}
+
+static double maxSincosErrorRad(float range) {
+  double worst = 0;
+  for (float angle = -range; angle <= range; angle += range/200000) {
+    float s, c;
+    fast_sincos(angle, s, c);
+    worst = fmax(worst, fmax(fabs(s - sin(double(angle))), fabs(c - cos(double(angle)))));
+  }
+  return worst;
+}
+
+int main() {
+  int mismatches = checkWrap();
+  printf("wrap_angle vs old loop: %d mismatches\n", mismatches);
+  printf("fast_sincos_deg max error (+/-1e5 deg): %.2e\n", maxSincosErrorDeg(1e5f));
+  printf("fast_sincos max error (+/-1e3 rad):     %.2e\n", maxSincosErrorRad(1e3f));
+
+  //A heading delta after a short run, and a gyro rotation after a long skills run
+  const float ranges[] = {540.0f, 36000.0f};
+  for (unsigned int ii = 0; ii < sizeof(ranges)/sizeof(ranges[0]); ii++) {
+    makeSamples(ranges[ii]);
+    printf("\nangles within +/-%.0f deg\n", ranges[ii]);
+    printf("  loop reduce      %7.2f ns/call\n", timeKernel([](float a) { return loop_reduce_negative_180_to_180(a); }));
+    printf("  wrap_angle       %7.2f ns/call\n", timeKernel([](float a) { return wrap_angle(a, -180, 360); }));
+    printf("  sinf + cosf      %7.2f ns/call\n", timeKernel([](float a) { float r = a*float(M_PI/180); return sinf(r) + cosf(r); }));
+    printf("  fast_sincos_deg  %7.2f ns/call\n", timeKernel([](float a) { float s, c; fast_sincos_deg(a, s, c); return s + c; }));
+  }
+  return mismatches == 0 ? 0 : 1;
+}
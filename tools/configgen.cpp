@@ -0,0 +1,137 @@
+/* ******************************************************************************* */
+/* Builds and reads config.bin, the SD card config the robot loads in pre_auton    */
+/* (see include/1091A_ConfigStore.h). Uses the same format code as the robot       */
+/* (src/1091A_ConfigFormat.cpp), so the file always matches what it expects.       */
+/*                                                                                 */
+/*   configgen defaults                   print the compiled-in values as text    */
+/*   configgen build <text> <config.bin>  text to a config file                   */
+/*   configgen dump <config.bin>          config file to text                     */
+/*                                                                                 */
+/* Text format (one section per line, '#' starts a comment): the section name and  */
+/* then every value in it, in the order "configgen defaults" prints them.          */
+/* Sections left out keep their compiled-in values.                                */
+/* ******************************************************************************* */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "1091A_ConfigStore.h"
+
+static float* configFloats(RobotConfig& config) { return reinterpret_cast<float*>(&config); }
+
+/// @brief Print the config in the text format
+static void printConfig(FILE* out, RobotConfig& config) {
+  const float* values = configFloats(config);
+  fprintf(out, "# 1091A robot config, version %d\n", ROBOT_CONFIG_VERSION);
+  fprintf(out, "# turn/swing/turn presets: volts settle_err settle_ms timeout kp ki kd starti\n");
+  fprintf(out, "# drive/drive presets: volts min_volts heading_volts settle_err settle_ms timeout kp ki kd starti"
+    " heading_kp heading_ki heading_kd heading_starti lead setback (starti is per inch in the presets)\n");
+  for (int ii = 0; ii < robotConfigSectionCount; ii++) {
+    const RobotConfigSection& section = robotConfigSections[ii];
+    fprintf(out, "%s", section.name);
+    for (int jj = 0; jj < section.count; jj++) fprintf(out, " %g", values[section.offset + jj]);
+    fprintf(out, "\n");
+  }
+}
+
+/// @brief Read a text config over the compiled-in values
+/// @return false on an unknown section, a wrong value count, or values that fail the robot's checks
+static bool readConfigText(const char* fileName, RobotConfig& config) {
+  FILE* in = fopen(fileName, "r");
+  if (in == NULL) {
+    fprintf(stderr, "%s: cannot open\n", fileName);
+    return false;
+  }
+
+  config = robotConfigDefaults;
+  float* values = configFloats(config);
+  bool ok = true;
+  char line[512];
+  int lineNumber = 0;
+  while (ok && fgets(line, sizeof(line), in) != NULL) {
+    lineNumber++;
+    char* comment = strchr(line, '#');
+    if (comment != NULL) *comment = '\0';
+
+    char name[32];
+    int nameLength = 0;
+    if (sscanf(line, "%31s%n", name, &nameLength) != 1) continue;  //Blank line
+
+    const RobotConfigSection* section = NULL;
+    for (int ii = 0; ii < robotConfigSectionCount; ii++) {
+      if (strcmp(name, robotConfigSections[ii].name) == 0) section = &robotConfigSections[ii];
+    }
+    if (section == NULL) {
+      fprintf(stderr, "%s:%d: unknown section \"%s\"\n", fileName, lineNumber, name);
+      ok = false;
+      break;
+    }
+
+    const char* text = line + nameLength;
+    int count = 0;
+    while (true) {
+      char* end;
+      float value = strtof(text, &end);
+      if (end == text) break;
+      if (count < section->count) values[section->offset + count] = value;
+      count++;
+      text = end;
+    }
+    while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n') text++;
+    if (count != section->count || *text != '\0') {
+      fprintf(stderr, "%s:%d: %s takes %d numbers\n", fileName, lineNumber, name, section->count);
+      ok = false;
+    }
+  }
+  fclose(in);
+
+  if (ok && !robotConfigValid(config)) {
+    fprintf(stderr, "%s: values out of range (the robot would ignore this file)\n", fileName);
+    ok = false;
+  }
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  static uint8_t file[robotConfigFileBytes + 1];
+  RobotConfig config = robotConfigDefaults;
+
+  if (argc == 2 && strcmp(argv[1], "defaults") == 0) {
+    printConfig(stdout, config);
+    return 0;
+  }
+
+  if (argc == 4 && strcmp(argv[1], "build") == 0) {
+    if (!readConfigText(argv[2], config)) return 1;
+    int length = encodeRobotConfig(config, file, sizeof(file));
+    FILE* out = fopen(argv[3], "wb");
+    if (out == NULL || fwrite(file, 1, length, out) != static_cast<size_t>(length)) {
+      fprintf(stderr, "%s: cannot write\n", argv[3]);
+      if (out != NULL) fclose(out);
+      return 1;
+    }
+    fclose(out);
+    return 0;
+  }
+
+  if (argc == 3 && strcmp(argv[1], "dump") == 0) {
+    FILE* in = fopen(argv[2], "rb");
+    if (in == NULL) {
+      fprintf(stderr, "%s: cannot open\n", argv[2]);
+      return 1;
+    }
+    int length = static_cast<int>(fread(file, 1, sizeof(file), in));
+    fclose(in);
+    RobotConfigStatus status = decodeRobotConfig(file, length, config);
+    if (status != CONFIG_LOADED) {
+      const char* reason = (status == CONFIG_BAD_CHECKSUM) ? "bad checksum" : (status == CONFIG_BAD_VALUES) ? "values out of range" : "wrong version or size";
+      fprintf(stderr, "%s: the robot would not use this file (%s)\n", argv[2], reason);
+      return 1;
+    }
+    printConfig(stdout, config);
+    return 0;
+  }
+
+  fprintf(stderr, "usage: configgen defaults | build <text> <config.bin> | dump <config.bin>\n");
+  return 1;
+}
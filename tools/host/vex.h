@@ -0,0 +1,39 @@
+#pragma once
+
+/* ******************************************************************************* */
+/* PC stand-in for vex.h, used only by the host benchmarks (make bench-host). It   */
+/* gives the hardware-free JAR-Template sources (PID, odom, util) the one thing    */
+/* they need from the SDK, Brain.Timer, so they build unchanged with a PC g++.     */
+/* ******************************************************************************* */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+
+namespace vex {
+  class timer {
+  public:
+    /// @brief Seconds since the program started, like the brain's timer
+    double value() const {
+      static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+  };
+  class brain {
+  public:
+    timer Timer;
+  };
+}
+
+extern vex::brain Brain;
+
+#include "JAR-Template/fast_math.h"
+#include "JAR-Template/mpc.h"
+#include "JAR-Template/trajectory.h"
+#include "JAR-Template/odom.h"
+#include "JAR-Template/util.h"
+#include "JAR-Template/PID.h"
@@ -0,0 +1,179 @@
+/* ******************************************************************************* */
+/* Builds the trajectory tables the robot follows. Reads the .path definitions in  */
+/* paths/, plans each one with the same code the robot has                         */
+/* (src/JAR-Template/trajectory.cpp) and writes them as constexpr arrays, so on    */
+/* the brain a path is a table in flash: no spline math at auton start and no RAM. */
+/* The makefile runs this whenever a .path file changes.                           */
+/*                                                                                 */
+/*   pathgen include/1091A_PathTables.h paths/a.path paths/b.path ...              */
+/*                                                                                 */
+/* Path file format (one command per line, '#' starts a comment):                  */
+/*   constraints <wheel in/s> <wheel in/s^2> <centripetal in/s^2> <track width in> */
+/*   spacing <inches between points>            (default 1)                        */
+/*   path <name>                                starts a new path                  */
+/*   waypoint <x> <y> <heading>                 odom frame, heading of travel      */
+/* constraints and spacing apply to the paths after them, and carry over between   */
+/* files.                                                                          */
+/* ******************************************************************************* */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "JAR-Template/trajectory.h"
+
+#define PATHGEN_MAX_WAYPOINTS 32
+#define PATHGEN_MAX_POINTS 2000
+#define PATHGEN_MAX_NAME 48
+
+struct PathDefinition {
+  char name[PATHGEN_MAX_NAME];
+  path_waypoint waypoints[PATHGEN_MAX_WAYPOINTS];
+  int waypointCount;
+  trajectory_constraints constraints;
+  float spacing;
+};
+
+static path_point pathPoints[PATHGEN_MAX_POINTS];
+static trajectory_point trajectoryPoints[PATHGEN_MAX_POINTS];
+
+/// @brief Print a float as a C++ float literal ("0" would not take an f suffix)
+static void printFloat(FILE* out, float value) {
+  char text[32];
+  snprintf(text, sizeof(text), "%.7g", value);
+  if (strchr(text, '.') == NULL && strchr(text, 'e') == NULL && strchr(text, 'n') == NULL) strcat(text, ".0");
+  fprintf(out, "%sf", text);
+}
+
+static bool validName(const char* name) {
+  if (name[0] == '\0' || isdigit(static_cast<unsigned char>(name[0]))) return false;
+  for (const char* c = name; *c != '\0'; c++) {
+    if (!isalnum(static_cast<unsigned char>(*c)) && *c != '_') return false;
+  }
+  return strlen(name) < PATHGEN_MAX_NAME;
+}
+
+/// @brief Plan one path and write it to the header
+/// @return false if the path could not be planned
+static bool emitPath(FILE* out, const PathDefinition& path, const char* fileName) {
+  if (path.waypointCount < 2) {
+    fprintf(stderr, "%s: path %s needs at least 2 waypoints\n", fileName, path.name);
+    return false;
+  }
+  int pointCount = sample_path(path.waypoints, path.waypointCount, path.spacing, pathPoints, PATHGEN_MAX_POINTS);
+  if (pointCount >= PATHGEN_MAX_POINTS) {
+    fprintf(stderr, "%s: path %s is longer than %d points; use a bigger spacing\n", fileName, path.name, PATHGEN_MAX_POINTS);
+    return false;
+  }
+  int trajectoryCount = plan_trajectory(pathPoints, pointCount, path.constraints, trajectoryPoints);
+  const trajectory_point& last = trajectoryPoints[trajectoryCount-1];
+
+  fprintf(out, "// %s: %s, %d points, %.1f in, %.2f s\n", path.name, fileName, trajectoryCount, last.distance, last.time);
+  fprintf(out, "constexpr trajectory_point %s[] = {\n", path.name);
+  for (int ii = 0; ii < trajectoryCount; ii++) {
+    const trajectory_point& p = trajectoryPoints[ii];
+    const float fields[] = {p.time, p.distance, p.x, p.y, p.heading_deg, p.curvature, p.velocity, p.acceleration};
+    fprintf(out, "  {");
+    for (unsigned int jj = 0; jj < sizeof(fields)/sizeof(fields[0]); jj++) {
+      if (jj > 0) fprintf(out, ", ");
+      printFloat(out, fields[jj]);
+    }
+    fprintf(out, "},\n");
+  }
+  fprintf(out, "};\n");
+  fprintf(out, "constexpr int %s_count = %d;\n\n", path.name, trajectoryCount);
+  return true;
+}
+
+/// @brief Read one path file, writing each path in it as it ends
+/// @return false on a syntax error or a path that could not be planned
+static bool processFile(FILE* out, const char* fileName, trajectory_constraints& constraints, bool& haveConstraints, float& spacing) {
+  FILE* in = fopen(fileName, "r");
+  if (in == NULL) {
+    fprintf(stderr, "%s: cannot open\n", fileName);
+    return false;
+  }
+
+  PathDefinition path;
+  bool inPath = false;
+  bool ok = true;
+  char line[256];
+  int lineNumber = 0;
+  while (ok && fgets(line, sizeof(line), in) != NULL) {
+    lineNumber++;
+    char* comment = strchr(line, '#');
+    if (comment != NULL) *comment = '\0';
+
+    char keyword[32];
+    if (sscanf(line, "%31s", keyword) != 1) continue;  //Blank line
+
+    if (strcmp(keyword, "constraints") == 0) {
+      trajectory_constraints c = {};
+      if (sscanf(line, "%*s %f %f %f %f", &c.max_wheel_speed, &c.max_wheel_accel, &c.max_centripetal_accel, &c.track_width) != 4) ok = false;
+      constraints = c;
+      haveConstraints = true;
+    } else if (strcmp(keyword, "spacing") == 0) {
+      if (sscanf(line, "%*s %f", &spacing) != 1 || spacing <= 0) ok = false;
+    } else if (strcmp(keyword, "path") == 0) {
+      if (inPath) ok = emitPath(out, path, fileName);
+      if (!ok) break;
+      if (!haveConstraints) {
+        fprintf(stderr, "%s:%d: constraints must come before the first path\n", fileName, lineNumber);
+        ok = false;
+        break;
+      }
+      if (sscanf(line, "%*s %47s", path.name) != 1 || !validName(path.name)) ok = false;
+      path.waypointCount = 0;
+      path.constraints = constraints;
+      path.spacing = spacing;
+      inPath = true;
+    } else if (strcmp(keyword, "waypoint") == 0 && inPath && path.waypointCount < PATHGEN_MAX_WAYPOINTS) {
+      path_waypoint& w = path.waypoints[path.waypointCount++];
+      if (sscanf(line, "%*s %f %f %f", &w.x, &w.y, &w.heading_deg) != 3) ok = false;
+    } else {
+      ok = false;
+    }
+    if (!ok) fprintf(stderr, "%s:%d: cannot read \"%s\"\n", fileName, lineNumber, keyword);
+  }
+  if (ok && inPath) ok = emitPath(out, path, fileName);
+  fclose(in);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: pathgen <output header> <path files...>\n");
+    return 1;
+  }
+
+  //Write to a temporary file and rename it at the end, so a failed run leaves the old tables alone
+  char tempName[512];
+  snprintf(tempName, sizeof(tempName), "%s.tmp", argv[1]);
+  FILE* out = fopen(tempName, "w");
+  if (out == NULL) {
+    fprintf(stderr, "%s: cannot write\n", tempName);
+    return 1;
+  }
+  fprintf(out, "#pragma once\n");
+  fprintf(out, "#include \"JAR-Template/trajectory.h\"\n\n");
+  fprintf(out, "// Generated by tools/pathgen.cpp from paths/*.path. Do not edit; edit the .path files and rebuild.\n");
+  fprintf(out, "// Fields: time, distance, x, y, heading_deg, curvature, velocity, acceleration.\n\n");
+
+  trajectory_constraints constraints = {};
+  bool haveConstraints = false;
+  float spacing = 1;
+  bool ok = true;
+  for (int ii = 2; ii < argc && ok; ii++) ok = processFile(out, argv[ii], constraints, haveConstraints, spacing);
+  fclose(out);
+
+  if (!ok) {
+    remove(tempName);
+    return 1;
+  }
+  remove(argv[1]);
+  if (rename(tempName, argv[1]) != 0) {
+    fprintf(stderr, "%s: cannot write\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}